@@ -27,9 +27,9 @@ public:
 	void Move(float a_deltaTime,
 		const glm::vec3& a_up = glm::vec3(0, 1, 0));
 	void UpdateProjectionView();
-	void UpdateCameraPosition();
 	glm::mat4 GetCameraMatrix() const;
 	glm::mat4 GetProjectionMatrix() const;
+	glm::mat4 GetProjectionViewMatrix() const;
 
 private:
 #ifdef WIN64
@@ -0,0 +1,149 @@
+//////////////////////////////
+// File: FrustumCuller.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include "GLM/glm.hpp"
+#include "RenderQueue.h"
+#include "SceneBVH.h"
+#include <vector>
+
+class GeometryStore;
+class InstanceBuffer;
+
+/// <summary>
+/// Tests every instance of the frame's draws against the camera frustum before anything reaches the render queue. 
+/// Instances are bounded by world space spheres held in a BVH, groups wholly inside or outside the frustum are decided 
+/// there and only instances crossing a plane have their spheres tested, four at a time against each plane. Draws are 
+/// resubmitted with only their visible instances, which are listed in a storage buffer the OBJ vertex shader reads 
+/// transforms through. Each visible draw is also given the texels per unit of UV its nearest instance covers on screen, 
+/// for texture streaming.
+/// </summary>
+class FrustumCuller
+{
+public:
+	enum PLANES
+	{
+		PLANES_LEFT = 0,
+		PLANES_RIGHT,
+		PLANES_BOTTOM,
+		PLANES_TOP,
+		PLANES_NEAR,
+		PLANES_FAR,
+		PLANES_COUNT
+	};
+
+	typedef struct Statistics
+	{
+		unsigned int drawsVisible;
+		unsigned int drawsCulled;
+		unsigned int instancesVisible;
+		unsigned int instancesCulled;
+		// Instances the BVH couldn't decide, which had their spheres tested.
+		unsigned int spheresTested;
+		// Whether the BVH was rebuilt or refitted this frame.
+		bool bBVHRebuilt;
+		bool bBVHRefitted;
+	} Statistics;
+
+	typedef struct RayCandidate
+	{
+		unsigned int geometryHandle;
+		unsigned int instance;
+		// Distance along the ray to where it enters the instance's bounds.
+		float distance;
+	} RayCandidate;
+
+	FrustumCuller(const GeometryStore* a_pGeometryStore,
+		const InstanceBuffer* a_pInstanceBuffer);
+	~FrustumCuller();
+
+	// Extracts the inward facing, normalized planes of a projection-view 
+	// matrix's frustum.
+	static void ExtractPlanes(const glm::mat4& a_projectionViewMatrix, glm::vec4* a_pPlanes);
+	// Extracts the frustum's planes and clears the last frame's draws. The 
+	// BVH is only refitted when instance transforms have changed. The 
+	// viewport's height in pixels sizes the texels each draw asks for.
+	void Begin(const glm::mat4& a_projectionViewMatrix, bool a_bTransformsChanged, float a_viewportHeight);
+	// Queues a draw, its instances' transforms must already be set.
+	void Add(const RenderQueue::DrawItem& a_item);
+	// Tests every queued instance and submits each draw that has visible 
+	// instances.
+	void Submit(RenderQueue* a_pRenderQueue);
+	// Finds the instances from the last Submit whose bounds the ray passes 
+	// through, nearest first. Culled instances are included.
+	void QueryRay(const glm::vec3& a_origin,
+		const glm::vec3& a_direction,
+		float a_maxDistance,
+		std::vector<RayCandidate>& a_candidates) const;
+	// Binds the visible instance list to its binding point.
+	void Bind() const;
+	// Disabled culling treats every instance as visible.
+	void SetEnabled(bool a_enabled);
+	bool IsEnabled() const;
+	// Counters for the last Submit call.
+	const Statistics& GetFrameStatistics() const;
+
+private:
+	// Fits world space spheres around every queued instance and rebuilds or 
+	// refits the BVH over them.
+	void UpdateBounds(bool a_bRebuild);
+	// Sets m_visible for each sphere listed in m_intersecting.
+	void TestSpheres();
+	void UploadVisibleInstances();
+
+	bool m_bEnabled;
+	bool m_bTransformsChanged;
+	unsigned int m_uiVisibleBuffer;
+	// Instances the visible list's buffer has room for.
+	unsigned int m_uiVisibleCapacity;
+	// Plane equations with the normals facing inwards, one array per 
+	// component so four spheres can be tested against a plane at once.
+	float m_planeX[PLANES_COUNT];
+	float m_planeY[PLANES_COUNT];
+	float m_planeZ[PLANES_COUNT];
+	float m_planeW[PLANES_COUNT];
+	glm::vec4 m_planes[PLANES_COUNT];
+	// Projection-view row giving a point's view depth, and the pixels a 
+	// world unit covers at a depth of one.
+	glm::vec4 m_depthRow;
+	float m_fPixelsPerUnit;
+	const GeometryStore* m_pGeometryStore;
+	const InstanceBuffer* m_pInstanceBuffer;
+	std::vector<RenderQueue::DrawItem> m_items;
+	// Draws the BVH was built for, a different set needs a rebuild.
+	std::vector<RenderQueue::DrawItem> m_bvhItems;
+	// Index of each queued draw's first sphere.
+	std::vector<unsigned int> m_itemSpheres;
+	// World space bounding sphere of every queued instance.
+	std::vector<float> m_sphereX;
+	std::vector<float> m_sphereY;
+	std::vector<float> m_sphereZ;
+	std::vector<float> m_sphereRadius;
+	// World units one unit of UV spans on each instance.
+	std::vector<float> m_sphereUVDensities;
+	// Instance buffer index each sphere was made from.
+	std::vector<unsigned int> m_sphereInstances;
+	// Queued draw each sphere belongs to.
+	std::vector<unsigned int> m_sphereItems;
+	std::vector<SceneBVH::Box> m_sphereBoxes;
+	SceneBVH m_bvh;
+	// Spheres the BVH placed wholly inside the frustum or crossing a plane.
+	std::vector<unsigned int> m_inside;
+	std::vector<unsigned int> m_intersecting;
+	// Crossing spheres gathered for testing, padded to a multiple of four.
+	std::vector<float> m_testX;
+	std::vector<float> m_testY;
+	std::vector<float> m_testZ;
+	std::vector<float> m_testRadius;
+	std::vector<unsigned char> m_visible;
+	// Instance buffer indices of the visible instances, grouped by draw.
+	std::vector<unsigned int> m_visibleInstances;
+	Statistics m_frameStatistics;
+};
+
+#endif // FRUSTUM_CULLER_H.
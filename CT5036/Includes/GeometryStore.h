@@ -0,0 +1,91 @@
+//////////////////////////////
+// File: GeometryStore.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef GEOMETRY_STORE_H
+#define GEOMETRY_STORE_H
+
+#ifdef WIN64
+#include "GLAD/glad.h"
+#endif // WIN64.
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+#include "GLM/glm.hpp"
+#include <vector>
+
+class OBJMesh;
+
+/// <summary>
+/// Holds every OBJ mesh's vertices and indices in one shared vertex buffer and one shared index buffer.
+/// Meshes are given their ranges when added and are uploaded to the GPU once, draws then only need offsets into the buffers.
+/// </summary>
+class GeometryStore
+{
+public:
+	// Where a mesh's data lives within the shared buffers.
+	typedef struct MeshRange
+	{
+		// Offset of the mesh's first index, in indices.
+		unsigned int firstIndex;
+		unsigned int indexCount;
+		// Offset of the mesh's first vertex, added to each of its indices.
+		int baseVertex;
+		unsigned int vertexCount;
+		// Model space bounding sphere, centre in xyz and radius in w.
+		glm::vec4 boundingSphere;
+		// Model space units one unit of UV spans.
+		float uvDensity;
+	} MeshRange;
+
+	// Matches GL's DrawElementsIndirectCommand, so arrays of these can be 
+	// read straight from an indirect buffer.
+	typedef struct DrawCommand
+	{
+		unsigned int indexCount;
+		unsigned int instanceCount;
+		unsigned int firstIndex;
+		int baseVertex;
+		unsigned int baseInstance;
+	} DrawCommand;
+
+	GeometryStore(bool a_packedVertices);
+	~GeometryStore();
+
+	// Reserves space for a mesh. Its data is read when Upload is called so 
+	// the mesh must stay alive until then.
+	bool AddMesh(OBJMesh* a_pMesh, unsigned int& a_handle);
+	// Creates the buffers and copies every added mesh into them.
+	bool Upload();
+	// Draws instances of a mesh, the store's VAO must be bound. The first 
+	// instance is the shader's gl_BaseInstance.
+	void DrawMesh(unsigned int a_handle,
+		unsigned int a_firstInstance = 0,
+		unsigned int a_instanceCount = 1) const;
+	// Fills an indirect command that draws instances of a mesh.
+	void GetDrawCommand(unsigned int a_handle,
+		unsigned int a_firstInstance,
+		unsigned int a_instanceCount,
+		DrawCommand& a_command) const;
+	const MeshRange& GetMeshRange(unsigned int a_handle) const;
+	unsigned int GetVAO() const;
+
+private:
+	void SetupVertexAttributes() const;
+
+	bool m_bPackedVertices;
+	bool m_bUploaded;
+	unsigned int m_uiVAO;
+	unsigned int m_uiVertexBuffer;
+	unsigned int m_uiIndexBuffer;
+	unsigned int m_uiVertexStride;
+	unsigned int m_uiVertexCount;
+	unsigned int m_uiIndexCount;
+	std::vector<MeshRange> m_meshRanges;
+	// Meshes waiting to be copied into the buffers by Upload.
+	std::vector<OBJMesh*> m_pendingMeshes;
+};
+
+#endif // GEOMETRY_STORE_H.
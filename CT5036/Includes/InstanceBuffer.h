@@ -0,0 +1,43 @@
+//////////////////////////////
+// File: InstanceBuffer.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include "GLM/glm.hpp"
+#include <vector>
+
+/// <summary>
+/// World matrices for every drawn instance, kept in a storage buffer that the OBJ vertex shader indexes with the draw's 
+/// base instance plus gl_InstanceID. Only transforms that changed since the last upload are sent to the GPU.
+/// </summary>
+class InstanceBuffer
+{
+public:
+	InstanceBuffer();
+	~InstanceBuffer();
+
+	// Reserves consecutive transforms and returns the first one's index. New 
+	// transforms start as identity matrices.
+	unsigned int Allocate(unsigned int a_count);
+	void SetTransform(unsigned int a_instance, const glm::mat4& a_transform);
+	const glm::mat4& GetTransform(unsigned int a_instance) const;
+	unsigned int GetInstanceCount() const;
+	// Sends the transforms changed since the last upload to the GPU.
+	void Upload();
+	void Bind() const;
+
+private:
+	unsigned int m_uiBuffer;
+	// Transforms the GPU buffer has room for.
+	unsigned int m_uiCapacity;
+	// Range of transforms changed since the last upload.
+	unsigned int m_uiDirtyBegin;
+	unsigned int m_uiDirtyEnd;
+	std::vector<glm::mat4> m_transforms;
+};
+
+#endif // INSTANCE_BUFFER_H.
@@ -0,0 +1,97 @@
+//////////////////////////////
+// File: MeshBVH.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include "GLM/glm.hpp"
+#include <vector>
+
+class OBJMesh;
+class SceneBVH;
+
+/// <summary>
+/// Four wide bounding volume hierarchy over one mesh's triangles, for finding the closest triangle along a ray. Each node 
+/// keeps its four children's bounds side by side so a ray is tested against all of them at once, and leaf triangles are 
+/// stored in traversal order so four can be intersected at once.
+/// </summary>
+class MeshBVH
+{
+public:
+	typedef struct Hit
+	{
+		float distance;
+		// Index of the triangle's first index in the mesh's index list, 
+		// divided by three.
+		unsigned int triangle;
+		// Weights of the triangle's second and third vertices, the first's 
+		// is 1 - u - v.
+		float u;
+		float v;
+	} Hit;
+
+	MeshBVH();
+	~MeshBVH();
+
+	// Builds the hierarchy over the mesh's triangles in model space.
+	void Build(OBJMesh* a_pMesh);
+	// Finds the closest triangle the ray hits within the maximum distance. 
+	// Distances are measured in multiples of the direction's length.
+	bool Raycast(const glm::vec3& a_origin,
+		const glm::vec3& a_direction,
+		float a_maxDistance,
+		Hit& a_hit) const;
+	unsigned int GetTriangleCount() const;
+	unsigned int GetNodeCount() const;
+
+private:
+	// Marks a child slot with nothing in it.
+	static const unsigned int ms_uiEmptyChild;
+
+	typedef struct Node
+	{
+		// Children's bounds, one array per component.
+		float minX[4];
+		float minY[4];
+		float minZ[4];
+		float maxX[4];
+		float maxY[4];
+		float maxZ[4];
+		// Node index for interior children, first triangle for leaves.
+		unsigned int children[4];
+		// Triangles in a leaf child, 0 for interior children.
+		unsigned int counts[4];
+	} Node;
+
+	// Fills a node with up to four descendants of a binary node, opening the 
+	// largest interior descendant until four are found.
+	void Collapse(const SceneBVH& a_binary, unsigned int a_binaryNode, unsigned int a_node);
+	// Tests a leaf's triangles four at a time and updates the hit when one is 
+	// closer.
+	void IntersectTriangles(unsigned int a_first,
+		unsigned int a_count,
+		const glm::vec3& a_origin,
+		const glm::vec3& a_direction,
+		Hit& a_hit) const;
+
+	unsigned int m_uiTriangleCount;
+	std::vector<Node> m_nodes;
+	// Triangles in leaf order as a corner and the two edges leaving it, one 
+	// array per component. Padded so four can always be loaded.
+	std::vector<float> m_cornerX;
+	std::vector<float> m_cornerY;
+	std::vector<float> m_cornerZ;
+	std::vector<float> m_edgeAX;
+	std::vector<float> m_edgeAY;
+	std::vector<float> m_edgeAZ;
+	std::vector<float> m_edgeBX;
+	std::vector<float> m_edgeBY;
+	std::vector<float> m_edgeBZ;
+	// Original index of each stored triangle.
+	std::vector<unsigned int> m_triangles;
+};
+
+#endif // MESH_BVH_H.
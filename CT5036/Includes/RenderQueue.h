@@ -0,0 +1,121 @@
+//////////////////////////////
+// File: RenderQueue.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "GeometryStore.h"
+#include <vector>
+
+/// <summary>
+/// Collects a frame's draws, sorts them by state and submits them while skipping any program or texture change that's 
+/// already in effect. Every draw is written into an indirect command buffer, so runs of draws sharing state can be 
+/// submitted with a single glMultiDrawElementsIndirect call. Material indices are read per draw from a storage buffer.
+/// When the texture manager's textures are bindless they're sampled through the material table instead of bound, so runs 
+/// only split where the program changes.
+/// </summary>
+class RenderQueue
+{
+public:
+	enum TEXTURE_UNITS
+	{
+		TEXTURE_UNITS_DIFFUSE = 0,
+		TEXTURE_UNITS_SPECULAR,
+		TEXTURE_UNITS_NORMAL,
+		TEXTURE_UNITS_COUNT
+	};
+
+	typedef struct DrawItem
+	{
+		unsigned int program;
+		// Index into the shader constants' material table.
+		unsigned int materialIndex;
+		// Texture manager handle for each TEXTURE_UNITS unit, or 
+		// ms_uiUnusedTexture to leave the unit's current binding alone. 
+		// Bindless draws sample the material's textures, these only mark 
+		// them as used.
+		unsigned int textures[TEXTURE_UNITS_COUNT];
+		// Texels across each unit of UV the nearest visible instance covers 
+		// on screen, set by the frustum culler. 0 asks for full resolution.
+		float texelsPerUV;
+		unsigned int geometryHandle;
+		// Range of world matrices in the instance buffer, one per instance.
+		unsigned int firstInstance;
+		unsigned int instanceCount;
+	} DrawItem;
+
+	typedef struct Statistics
+	{
+		// Meshes drawn, each is one indirect command.
+		unsigned int draws;
+		unsigned int instances;
+		// GL draw calls issued for them.
+		unsigned int drawCalls;
+		unsigned int programBinds;
+		unsigned int programBindsAvoided;
+		unsigned int textureBinds;
+		unsigned int textureBindsAvoided;
+	} Statistics;
+
+	static const unsigned int ms_uiUnusedTexture;
+
+	RenderQueue();
+	~RenderQueue();
+
+	void Submit(const DrawItem& a_item);
+	// Sorts the submitted items, draws them and empties the queue. The 
+	// geometry store's VAO must be bound.
+	void Execute(const GeometryStore* a_pGeometryStore);
+	// Submits runs of draws sharing state with one multi-draw call, 
+	// otherwise every draw is its own call.
+	void SetMultiDraw(bool a_multiDraw);
+	bool IsMultiDraw() const;
+	// Counters for the last Execute call.
+	const Statistics& GetFrameStatistics() const;
+	// Counters summed over every Execute call.
+	const Statistics& GetTotalStatistics() const;
+
+private:
+	typedef struct SortEntry
+	{
+		unsigned long long key;
+		unsigned int item;
+
+		bool operator < (const SortEntry& a_rhs) const
+		{
+			return key < a_rhs.key || (key == a_rhs.key && item < a_rhs.item);
+		}
+	} SortEntry;
+
+	// Packs the state that's most expensive to change into the highest bits 
+	// so sorting groups it together. From the top: program, diffuse 
+	// texture, material and mesh, 16 bits each. The texture is left out 
+	// when textures aren't bound.
+	static unsigned long long MakeSortKey(const DrawItem& a_item, bool a_bTextures);
+	static void AddStatistics(Statistics& a_total, const Statistics& a_frame);
+	// Copies this frame's commands and per draw data to the GPU, growing the 
+	// buffers when needed.
+	void UploadDrawData();
+	// Draws the commands in [a_first, a_first + a_count) with one call.
+	void SubmitMultiDraw(unsigned int a_first,
+		unsigned int a_count,
+		int a_drawOffsetLocation);
+
+	bool m_bMultiDraw;
+	unsigned int m_uiCommandBuffer;
+	unsigned int m_uiDrawDataBuffer;
+	// Commands the GPU buffers have room for.
+	unsigned int m_uiDrawCapacity;
+	std::vector<DrawItem> m_items;
+	std::vector<SortEntry> m_sortEntries;
+	// Sorted commands and their material indices, in submission order.
+	std::vector<GeometryStore::DrawCommand> m_drawCommands;
+	std::vector<unsigned int> m_drawMaterials;
+	Statistics m_frameStatistics;
+	Statistics m_totalStatistics;
+};
+
+#endif // RENDER_QUEUE_H.
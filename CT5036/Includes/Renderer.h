@@ -12,13 +12,21 @@
 #include "GLAD/glad.h"
 #endif // WIN64.
 #include "GLM/glm.hpp"
+#include "RenderQueue.h"
+#include <vector>
 #ifdef NX64
 #include <nn/nn_Log.h>
 #include <nn/gll.h>
 #endif // NX64.
 
 class DebugCamera;
+class FrustumCuller;
+class GeometryStore;
+class InstanceBuffer;
 class OBJModel;
+class SceneGraph;
+class ScenePicker;
+class ShaderConstants;
 class Skybox;
 
 /// <summary>
@@ -38,6 +46,9 @@ public:
 	const OBJModel* GetModel(unsigned int a_model) const;
 	const unsigned int GetNumberOfModels() const;
 	DebugCamera* GetCamera() const;
+	// Adds the 10,000 prop benchmark field to the scene, must be set before 
+	// Run.
+	void SetPropField(bool a_bPropField);
 
 protected:
 	virtual bool OnCreate();
@@ -60,7 +71,31 @@ private:
 		Vertex v1;
 	} Line;
 
+	// Props repeated across the instancing benchmark field.
+	enum PROPS
+	{
+		PROPS_CRATE = 0,
+		PROPS_BARREL,
+		PROPS_CHEST,
+		PROPS_COUNT
+	};
+
 	void SetProgram(unsigned int a_program);
+#ifdef WIN64
+	// True on the frame a key goes down. The flag tracks the key between 
+	// calls.
+	static bool KeyPressed(int a_key, bool& a_bKeyDown);
+#endif // WIN64.
+	// Loads a model, registers its materials and textures and reserves its 
+	// meshes in the geometry store. Each mesh's draw is added to the list 
+	// without an instance range.
+	bool LoadOBJModel(OBJModel* a_pModel,
+		unsigned int a_defaultMaterialIndex,
+		std::vector<RenderQueue::DrawItem>& a_meshDraws);
+	// Gives every draw in the list the same instance range.
+	void SetInstances(std::vector<RenderQueue::DrawItem>& a_meshDraws,
+		unsigned int a_firstInstance,
+		unsigned int a_instanceCount);
 
 	unsigned int m_uiNumberOfModels;
 	/// <summary>
@@ -74,11 +109,79 @@ private:
 	/// Variable to keep track of currently bound shader program
 	/// </summary>
 	unsigned int m_uiCurrentProgram;
-	unsigned int m_uiOBJModelVAO;
-	unsigned int m_uiOBJModelBuffer[2];
+	/// <summary>
+	/// Loads OBJ models with OBJPackedVertex instead of OBJVertex, halving their vertex data.
+	/// </summary>
+	bool m_bPackOBJVertices;
+	/// <summary>
+	/// Packs each model's small textures of a type into one atlas, so its materials share a texture object.
+	/// </summary>
+	bool m_bPackTextureAtlases;
+	/// <summary>
+	/// Builds the instancing benchmark's field of props, off unless the application is started with -benchmark.
+	/// </summary>
+	bool m_bPropField;
+	/// <summary>
+	/// Draws the prop field with one instanced draw per mesh instead of one draw per instance. Toggled with 'I'.
+	/// </summary>
+	bool m_bInstanceProps;
+	/// <summary>
+	/// Draw CPU time accumulated since the last benchmark report.
+	/// </summary>
+	double m_dDrawSeconds;
+	unsigned int m_uiDrawFrames;
 
 	DebugCamera* m_poDebugCamera;
+	/// <summary>
+	/// Every OBJ mesh's geometry, uploaded to the GPU once after loading.
+	/// </summary>
+	GeometryStore* m_poGeometryStore;
+	/// <summary>
+	/// Per frame camera block and the material table shared by every OBJ mesh.
+	/// </summary>
+	ShaderConstants* m_poShaderConstants;
 	OBJModel* m_poOBJModels[2];
+	/// <summary>
+	/// Draw data for each model's meshes, in mesh order. Built at load and submitted to the render queue each frame.
+	/// </summary>
+	std::vector<RenderQueue::DrawItem> m_objMeshDraws[2];
+	/// <summary>
+	/// Each model's scene node, which places its instance.
+	/// </summary>
+	unsigned int m_uiOBJModelNodes[2];
+	/// <summary>
+	/// World matrices of every OBJ instance, read by the OBJ vertex shader.
+	/// </summary>
+	InstanceBuffer* m_poInstanceBuffer;
+	/// <summary>
+	/// Drops instances outside the camera's frustum before OBJ draws reach the render queue. Toggled with 'C'.
+	/// </summary>
+	FrustumCuller* m_poFrustumCuller;
+	/// <summary>
+	/// Transforms of every OBJ instance. Changed nodes are copied into the instance buffer each frame.
+	/// </summary>
+	SceneGraph* m_poSceneGraph;
+	/// <summary>
+	/// Finds the OBJ triangle under the cursor when the left mouse button is clicked.
+	/// </summary>
+	ScenePicker* m_poScenePicker;
+	/// <summary>
+	/// Root node of the prop field, spun with 'G' to move every prop through the hierarchy.
+	/// </summary>
+	unsigned int m_uiPropFieldNode;
+	bool m_bSpinProps;
+	float m_fPropFieldAngle;
+	glm::vec3 m_propFieldCentre;
+	/// <summary>
+	/// Scene nodes recomputed since the last benchmark report.
+	/// </summary>
+	unsigned int m_uiNodesUpdated;
+	OBJModel* m_poPropModels[PROPS_COUNT];
+	/// <summary>
+	/// Draw data for each prop's meshes, covering all of the prop's instances.
+	/// </summary>
+	std::vector<RenderQueue::DrawItem> m_propMeshDraws[PROPS_COUNT];
+	RenderQueue* m_poRenderQueue;
 	Line* m_pLines;
 	Skybox* m_poSkybox;
 };
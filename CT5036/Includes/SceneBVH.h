@@ -0,0 +1,97 @@
+//////////////////////////////
+// File: SceneBVH.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef SCENE_BVH_H
+#define SCENE_BVH_H
+
+#include "GLM/glm.hpp"
+#include <vector>
+
+/// <summary>
+/// Bounding volume hierarchy over a set of axis aligned boxes, such as every drawn mesh instance. It's built top down 
+/// with binned surface area heuristic splits and can be refitted when boxes move without rebuilding. Frustum and ray 
+/// queries walk it to skip whole groups of boxes at once.
+/// </summary>
+class SceneBVH
+{
+public:
+	typedef struct Box
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	} Box;
+
+	// Interior nodes' children are stored next to each other after them.
+	typedef struct Node
+	{
+		glm::vec3 min;
+		// First child for interior nodes, first item for leaves.
+		unsigned int first;
+		glm::vec3 max;
+		// Items in a leaf, 0 for interior nodes.
+		unsigned int count;
+	} Node;
+
+	typedef struct RayHit
+	{
+		unsigned int item;
+		// Distance along the ray to where it enters the item's box.
+		float distance;
+	} RayHit;
+
+	SceneBVH();
+	~SceneBVH();
+
+	// Builds the hierarchy over the boxes, items are the boxes' indices.
+	void Build(const std::vector<Box>& a_boxes);
+	// Updates every node's bounds for boxes that moved, keeping the tree's 
+	// shape. The box count must match the last build.
+	void Refit(const std::vector<Box>& a_boxes);
+	// Finds the items whose boxes touch the frustum, given as inward facing 
+	// normalized planes. Items in nodes wholly inside the frustum are added 
+	// to the inside list, the rest touch a plane and may still be outside.
+	void QueryFrustum(const glm::vec4* a_pPlanes,
+		unsigned int a_planeCount,
+		std::vector<unsigned int>& a_inside,
+		std::vector<unsigned int>& a_intersecting) const;
+	// Finds the items whose boxes the ray passes through within the maximum 
+	// distance, nearest entry first.
+	void QueryRay(const glm::vec3& a_origin,
+		const glm::vec3& a_direction,
+		float a_maxDistance,
+		std::vector<RayHit>& a_hits) const;
+	unsigned int GetItemCount() const;
+	unsigned int GetNodeCount() const;
+	// Node 0 is the root. Leaves' item ranges index GetItem.
+	const Node& GetNode(unsigned int a_node) const;
+	unsigned int GetItem(unsigned int a_index) const;
+	// Times building, refitting and querying random scenes of 1k, 10k and 
+	// 100k boxes seen through the given camera.
+	static void Benchmark(const glm::mat4& a_projectionViewMatrix);
+
+private:
+	// Centroids are sorted into this many bins along each axis when 
+	// searching for the cheapest split.
+	static const unsigned int ms_uiBinCount = 12;
+	// Leaves stop splitting at this size, or earlier when a split costs more 
+	// than testing their items.
+	static const unsigned int ms_uiMinLeafItems = 4;
+	// Leaves larger than this are split even when it doesn't pay off.
+	static const unsigned int ms_uiMaxLeafItems = 16;
+
+	void Subdivide(unsigned int a_node);
+	// Adds every item below a node to the list.
+	void AddSubtree(unsigned int a_node, std::vector<unsigned int>& a_items) const;
+	static float SurfaceArea(const glm::vec3& a_min, const glm::vec3& a_max);
+
+	std::vector<Node> m_nodes;
+	// Item indices, each leaf owns a contiguous range.
+	std::vector<unsigned int> m_items;
+	std::vector<Box> m_boxes;
+	std::vector<glm::vec3> m_centres;
+};
+
+#endif // SCENE_BVH_H.
@@ -0,0 +1,55 @@
+//////////////////////////////
+// File: SceneGraph.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include "GLM/glm.hpp"
+#include <vector>
+
+class InstanceBuffer;
+
+/// <summary>
+/// Hierarchy of scene nodes, each with a local and a world transform. Node data is kept in parallel arrays and nodes are 
+/// only created after their parent, so every parent's world transform is ready before its children need it. Changing a 
+/// local transform marks the node dirty, the next update then recomputes that node and its descendants in one pass.
+/// </summary>
+class SceneGraph
+{
+public:
+	static const unsigned int ms_uiNoParent;
+	static const unsigned int ms_uiNoInstance;
+
+	SceneGraph();
+	~SceneGraph();
+
+	// Adds a node below a parent, or at the root, and returns its index. A 
+	// node with an instance has its world transform copied into that slot 
+	// of the instance buffer whenever it changes.
+	unsigned int CreateNode(unsigned int a_parent = ms_uiNoParent,
+		const glm::mat4& a_localTransform = glm::mat4(1.0f),
+		unsigned int a_instance = ms_uiNoInstance);
+	void SetLocalTransform(unsigned int a_node, const glm::mat4& a_localTransform);
+	const glm::mat4& GetLocalTransform(unsigned int a_node) const;
+	// Only up to date after UpdateWorldTransforms.
+	const glm::mat4& GetWorldTransform(unsigned int a_node) const;
+	unsigned int GetParent(unsigned int a_node) const;
+	unsigned int GetNodeCount() const;
+	// Recomputes the world transform of every dirty node and its 
+	// descendants and returns how many were recomputed.
+	unsigned int UpdateWorldTransforms(InstanceBuffer* a_pInstanceBuffer);
+
+private:
+	// Lowest dirty node, the update starts here as nothing before it changed.
+	unsigned int m_uiFirstDirty;
+	std::vector<unsigned int> m_parents;
+	std::vector<unsigned int> m_instances;
+	std::vector<unsigned char> m_dirty;
+	std::vector<glm::mat4> m_localTransforms;
+	std::vector<glm::mat4> m_worldTransforms;
+};
+
+#endif // SCENE_GRAPH_H.
@@ -0,0 +1,89 @@
+//////////////////////////////
+// File: ScenePicker.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef SCENE_PICKER_H
+#define SCENE_PICKER_H
+
+#include "GLM/glm.hpp"
+#include <vector>
+
+class FrustumCuller;
+class InstanceBuffer;
+class MeshBVH;
+class OBJMesh;
+class OBJModel;
+
+/// <summary>
+/// Finds the closest OBJ triangle under a ray. The frustum culler's BVH narrows the scene down to instances whose bounds 
+/// the ray passes through, nearest first, then the ray is moved into each instance's model space and tested against its 
+/// mesh's triangle BVH. Triangle BVHs are built the first time a mesh is tested.
+/// </summary>
+class ScenePicker
+{
+public:
+	typedef struct Hit
+	{
+		OBJModel* pModel;
+		unsigned int mesh;
+		// Triangle within the mesh, its first index is three times this.
+		unsigned int triangle;
+		unsigned int instance;
+		// Weights of the triangle's three vertices.
+		glm::vec3 barycentrics;
+		glm::vec3 position;
+		float distance;
+	} Hit;
+
+	ScenePicker(const FrustumCuller* a_pFrustumCuller,
+		const InstanceBuffer* a_pInstanceBuffer);
+	~ScenePicker();
+
+	// Registers the mesh drawn with a geometry handle.
+	void AddMesh(unsigned int a_geometryHandle,
+		OBJMesh* a_pMesh,
+		OBJModel* a_pModel,
+		unsigned int a_meshIndex);
+	// Makes a world space ray through a window position, measured in pixels 
+	// from the top left. The ray starts on the near plane and its direction 
+	// is normalized.
+	static void ScreenToRay(float a_x,
+		float a_y,
+		float a_width,
+		float a_height,
+		const glm::mat4& a_projectionViewMatrix,
+		glm::vec3& a_origin,
+		glm::vec3& a_direction);
+	// Finds the closest triangle a normalized world space ray hits within the 
+	// maximum distance.
+	bool Raycast(const glm::vec3& a_origin,
+		const glm::vec3& a_direction,
+		float a_maxDistance,
+		Hit& a_hit);
+	// Finds the closest triangle under a window position.
+	bool Pick(float a_x,
+		float a_y,
+		float a_width,
+		float a_height,
+		const glm::mat4& a_projectionViewMatrix,
+		Hit& a_hit);
+
+private:
+	typedef struct Mesh
+	{
+		OBJMesh* pMesh;
+		OBJModel* pModel;
+		unsigned int meshIndex;
+		// Null until the mesh is first tested.
+		MeshBVH* pBVH;
+	} Mesh;
+
+	const FrustumCuller* m_pFrustumCuller;
+	const InstanceBuffer* m_pInstanceBuffer;
+	// Registered meshes, indexed by geometry handle.
+	std::vector<Mesh> m_meshes;
+};
+
+#endif // SCENE_PICKER_H.
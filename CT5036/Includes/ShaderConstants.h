@@ -0,0 +1,94 @@
+//////////////////////////////
+// File: ShaderConstants.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef SHADER_CONSTANTS_H
+#define SHADER_CONSTANTS_H
+
+#ifdef WIN64
+#include "GLAD/glad.h"
+#endif // WIN64.
+#include "GLM/glm.hpp"
+#include "OBJLoader.h"
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+#include <vector>
+
+/// <summary>
+/// Buffers of shader constants shared by every program. Camera data is written once per frame into a uniform block and 
+/// material colours and texture handles are uploaded once into a storage buffer that shaders index by material.
+/// </summary>
+class ShaderConstants
+{
+public:
+	// Binding points of the blocks, must match the shaders' binding layouts.
+	enum BINDINGS
+	{
+		BINDINGS_FRAME = 0,
+		BINDINGS_MATERIALS,
+		// Per instance world matrices, owned by InstanceBuffer.
+		BINDINGS_INSTANCES,
+		// Per draw material indices, written by RenderQueue each frame.
+		BINDINGS_DRAWS,
+		// Instance buffer indices of the visible instances, written by 
+		// FrustumCuller each frame.
+		BINDINGS_VISIBLE_INSTANCES,
+		// Bindless texture handles, owned by TextureTable.
+		BINDINGS_TEXTURES,
+		BINDINGS_COUNT
+	};
+
+	ShaderConstants();
+	~ShaderConstants();
+
+	// Queues a material for the table and returns its index. Materials can 
+	// only be added before Upload is called. Textures are texture manager 
+	// handles for the diffuse, specular and normal maps, 0 for none, each 
+	// with a UV scale and offset into its atlas. Null transforms sample 
+	// whole textures.
+	unsigned int AddMaterial(const glm::vec4& a_kA,
+		const glm::vec4& a_kD,
+		const glm::vec4& a_kS,
+		const glm::uvec4& a_textures = glm::uvec4(0),
+		const glm::vec4* a_pUVTransforms = nullptr);
+	// Creates the buffers and copies the material table into its buffer.
+	bool Upload();
+	// Writes this frame's camera data.
+	void UpdateFrame(const glm::mat4& a_projectionViewMatrix,
+		const glm::vec4& a_cameraPosition);
+	// Binds both buffers to their binding points.
+	void Bind() const;
+	unsigned int GetMaterialCount() const;
+
+private:
+	// Matches FrameConstants in the shaders (std140).
+	typedef struct FrameConstants
+	{
+		glm::mat4 projectionViewMatrix;
+		glm::vec4 cameraPosition;
+	} FrameConstants;
+
+	// Matches Material in the shaders (std430).
+	typedef struct MaterialConstants
+	{
+		glm::vec4 kA;
+		glm::vec4 kD;
+		glm::vec4 kS;
+		// Rows of the texture table, sampled when textures are bindless. 
+		// 0 marks a texture the material doesn't have, in either path.
+		glm::uvec4 textures;
+		// Scale in XY and offset in ZW of each texture's region of its 
+		// atlas.
+		glm::vec4 uvTransforms[OBJMaterial::TEXTURE_TYPES_COUNT];
+	} MaterialConstants;
+
+	bool m_bUploaded;
+	unsigned int m_uiFrameBuffer;
+	unsigned int m_uiMaterialBuffer;
+	std::vector<MaterialConstants> m_materials;
+};
+
+#endif // SHADER_CONSTANTS_H.
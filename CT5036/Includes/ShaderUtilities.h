@@ -7,6 +7,8 @@
 #ifndef SHADER_UTILITIES_H
 #define SHADER_UTILITIES_H
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 /// <summary>
@@ -16,6 +18,22 @@
 class ShaderUtilities
 {
 public:
+	// Uniforms the renderer sets every frame. Their locations are resolved 
+	// once per program when it's created, so they can be fetched by ID 
+	// without string lookups.
+	enum UNIFORMS
+	{
+		UNIFORMS_DRAW_OFFSET = 0,
+		UNIFORMS_DIFFUSE_TEXTURE,
+		UNIFORMS_SPECULAR_TEXTURE,
+		UNIFORMS_NORMAL_TEXTURE,
+		UNIFORMS_BINDLESS_TEXTURES,
+		UNIFORMS_VIEW,
+		UNIFORMS_PROJECTION,
+		UNIFORMS_SKYBOX,
+		UNIFORMS_COUNT
+	};
+
 	static ShaderUtilities* CreateInstance();
 	static ShaderUtilities* GetInstance();
 	static void DestroyInstance();
@@ -25,8 +43,23 @@ public:
 	static unsigned int CreateProgram(const int& a_vertexShader,
 		const int& a_fragmentShader);
 	static void DeleteProgram(unsigned int a_program);
+	// Returns -1 if the program doesn't use the uniform.
+	static int GetUniformLocation(unsigned int a_program,
+		UNIFORMS a_uniform);
+	// Looks the name up in the program's reflected uniforms. Slower than 
+	// fetching by ID, so keep it out of per draw code.
+	static int GetUniformLocation(unsigned int a_program,
+		const char* a_name);
 
 private:
+	// Every active uniform of a linked program.
+	typedef struct ProgramUniforms
+	{
+		// Locations of the UNIFORMS IDs, -1 for any the program doesn't use.
+		int locations[UNIFORMS_COUNT];
+		std::unordered_map<std::string, int> locationsByName;
+	} ProgramUniforms;
+
 	// Constructor.
 	ShaderUtilities();
 	// Destructor.
@@ -38,10 +71,19 @@ private:
 	unsigned int CreateProgramInternal(const int& a_vertexShader,
 		const int& a_fragmentShader);
 	void DeleteProgramInternal(unsigned int a_program);
+	// Reads the program's active uniforms into m_programUniforms.
+	void ReflectUniforms(unsigned int a_program);
+	int GetUniformLocationInternal(unsigned int a_program,
+		UNIFORMS a_uniform) const;
+	int GetUniformLocationInternal(unsigned int a_program,
+		const char* a_name) const;
 
 	static ShaderUtilities* m_poInstance;
+	// Names of the UNIFORMS IDs as they're written in the shaders.
+	static const char* const ms_uniformNames[UNIFORMS_COUNT];
 	std::vector<unsigned int> m_shaders;
 	std::vector<unsigned int> m_programs;
+	std::unordered_map<unsigned int, ProgramUniforms> m_programUniforms;
 };
 
 #endif // SHADER_UTILITIES_H.
\ No newline at end of file
@@ -8,10 +8,13 @@
 #define TEXTURE_H
 
 #include <string>
+#include "TextureCache.h"
 
 /// <summary>
 /// Stores texture data.
 /// A texture is a data buffer that contains values which relate to pixel colours.
+/// Streamed textures keep drawing their current name while a pending one is uploaded. Either may hold only the smaller 
+/// mips, so resolution can be raised as it's needed or demoted and evicted to free GPU memory.
 /// </summary>
 class Texture
 {
@@ -20,17 +23,71 @@ public:
 	~Texture();
 
 	bool Load(std::string a_filename);
+	// Creates the texture with a single white texel, drawn in place of 
+	// textures that aren't resident.
+	void LoadPlaceholder();
+	// Replaces the texture's image with RGBA pixels and generates its mips.
+	void Upload(const unsigned char* a_pPixels, unsigned int a_width, unsigned int a_height);
+	// Creates immutable storage for the mips from the first level down under 
+	// a pending name. Levels the current name already holds are copied 
+	// across on the GPU, the returned level is where they start and the 
+	// levels above it must be uploaded. The current name is still drawn 
+	// until Commit.
+	unsigned int Allocate(unsigned int a_width,
+		unsigned int a_height,
+		unsigned int a_levelCount,
+		TextureCache::FORMATS a_format,
+		unsigned int a_firstLevel);
+	// Copies rows of texels into a pending mip, compressed rows must start 
+	// on a block. Levels are numbered from the full image's. With a pixel 
+	// unpack buffer bound the data is an offset into it.
+	void UploadRows(unsigned int a_level,
+		unsigned int a_firstRow,
+		unsigned int a_rowCount,
+		const void* a_pData,
+		unsigned int a_size);
+	// Replaces the current name with the fully uploaded pending one.
+	void Commit();
+	// Drops the largest resident mip by copying the rest into smaller 
+	// storage, failing when only one level is left.
+	bool Demote();
+	// Frees every mip, the texture must be streamed in again to be drawn.
+	void Evict();
 	void Unload();
 	void SetFilename(const char* a_pFilename);
 	void SetDimensions(const unsigned int a_width, const unsigned int a_height);
 	const std::string& GetFileName() const;
+	// 0 when nothing is resident.
 	unsigned int GetTextureID() const;
 	void GetDimensions(unsigned int& a_width, unsigned int& a_height) const;
+	// Mips of the full image, 0 until the first Allocate.
+	unsigned int GetLevelCount() const;
+	// Largest resident mip, 0 when the full image is resident.
+	unsigned int GetBaseLevel() const;
+	// GL internal format of the resident mips.
+	unsigned int GetInternalFormat() const;
+	// Changes whenever the current name's storage is replaced.
+	unsigned int GetStorageVersion() const;
+	// GPU bytes held by the current and pending names.
+	size_t GetSize() const;
+	// Bytes in the full image's levels from the first up to the end.
+	size_t GetLevelsSize(unsigned int a_firstLevel, unsigned int a_endLevel) const;
 
 private:
+	// Generates a texture name and sets its sampling state.
+	unsigned int CreateName() const;
+
 	unsigned int m_uiWidth;
 	unsigned int m_uiHeight;
+	unsigned int m_uiLevelCount;
+	unsigned int m_uiBaseLevel;
+	unsigned int m_uiPendingBaseLevel;
 	unsigned int m_uiTextureID;
+	unsigned int m_uiPendingID;
+	unsigned int m_uiStorageVersion;
+	size_t m_size;
+	size_t m_pendingSize;
+	TextureCache::FORMATS m_format;
 	std::string m_filename;
 };
 
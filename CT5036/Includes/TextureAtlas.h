@@ -0,0 +1,97 @@
+//////////////////////////////
+// File: TextureAtlas.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "OBJLoader.h"
+#include <string>
+#include <vector>
+
+class TextureCache;
+
+/// <summary>
+/// Packs a model's small textures of one type into a single image with a skyline packer, so its materials share one 
+/// texture object and its binds. Each member sits in a cell padded by a border wrapped from its opposite edges, and cells 
+/// are aligned so every kept mip's border is whole compressed blocks. Members are sampled through a UV scale and offset. 
+/// The packing is saved as a manifest next to the model, which decodes like an image file into the atlas's cache, at 
+/// runtime or by the offline baker.
+/// </summary>
+class TextureAtlas
+{
+public:
+	typedef struct Region
+	{
+		std::string filename;
+		// Position of the member's texels in the atlas, rows from the 
+		// bottom, and their size.
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+		unsigned int height;
+		// Stamp of the member's file, so the manifest changes with it.
+		unsigned long long sourceSize;
+		long long sourceModifiedTime;
+	} Region;
+
+	TextureAtlas();
+	~TextureAtlas();
+
+	// Packs the files small enough to share an atlas, returning how many 
+	// were packed. Others are left out, as are all of them when fewer than 
+	// two fit.
+	unsigned int Pack(const std::vector<std::string>& a_filenames);
+	// Writes the manifest, leaving the file alone when it's unchanged so its 
+	// cache stays valid.
+	bool Save(const char* a_pFilename) const;
+	bool Load(const char* a_pFilename);
+	// Builds the atlas's levels from its members' mips.
+	bool Compose(TextureCache& a_cache) const;
+	// Null when the file isn't packed in the atlas.
+	const Region* FindRegion(const std::string& a_filename) const;
+	// Scale in XY and offset in ZW from a member's UVs to the atlas's.
+	glm::vec4 GetUVTransform(const Region& a_region) const;
+	unsigned int GetRegionCount() const;
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+	static bool IsAtlas(const char* a_pFilename);
+	// Manifest of the atlas holding a model's textures of one type.
+	static std::string GetAtlasFileName(const char* a_pModelFilename, OBJMaterial::TEXTURE_TYPES a_type);
+	// Every texture of one type the model's materials use, once each.
+	static void GetModelTextures(OBJModel* a_pModel,
+		OBJMaterial::TEXTURE_TYPES a_type,
+		std::vector<std::string>& a_filenames);
+
+private:
+	typedef struct SkylineSegment
+	{
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+	} SkylineSegment;
+
+	// Packs the cells into the given width, returning the height used or 0 
+	// when it's taller than the largest atlas.
+	unsigned int PackCells(unsigned int a_width, std::vector<Region>& a_regions) const;
+	// Text written to the manifest.
+	std::string GetManifest() const;
+
+	// Largest member packed, in texels across.
+	static const unsigned int ms_uiMaxMemberSize;
+	// Texels of wrapped border around each member's top level.
+	static const unsigned int ms_uiBorder;
+	// Cell positions and sizes are multiples of this, so the border and 
+	// member of every kept mip start on a compressed block.
+	static const unsigned int ms_uiAlignment;
+	static const unsigned int ms_uiMaxSize;
+	// Levels an atlas keeps, the border of the last is one block wide.
+	static const unsigned int ms_uiLevelCount;
+	unsigned int m_uiWidth;
+	unsigned int m_uiHeight;
+	std::vector<Region> m_regions;
+};
+
+#endif // TEXTURE_ATLAS_H.
@@ -0,0 +1,105 @@
+//////////////////////////////
+// File: TextureCache.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "OBJLoader.h"
+#include <string>
+#include <vector>
+
+/// <summary>
+/// An image and its full mip chain, ready to upload. Built by decoding a source image, filtering each mip and block 
+/// compressing them on the CPU, or mapped straight from a binary cache written next to the source, so later loads skip 
+/// decoding altogether. Holds no GL objects, so it can be built on worker threads and by the offline baker. A texture 
+/// atlas's manifest stands in for a source image, so atlases are built and cached the same way.
+/// </summary>
+class TextureCache
+{
+public:
+	enum FORMATS
+	{
+		FORMATS_RGBA8 = 0,
+		// Opaque colour, 8 bytes per 4x4 block.
+		FORMATS_BC1,
+		// Colour with alpha, 16 bytes per block.
+		FORMATS_BC3,
+		// Two channels for normal maps' X and Y, 16 bytes per block.
+		FORMATS_BC5,
+		FORMATS_COUNT
+	};
+
+	TextureCache();
+	~TextureCache();
+
+	// Decodes a source image and builds its mips. Rows run bottom to top, as 
+	// GL expects. Atlas manifests are decoded by composing their members.
+	bool Decode(const char* a_pSourceFilename);
+	// Lays out blank RGBA8 levels for an image built on the CPU.
+	void Create(unsigned int a_width, unsigned int a_height, unsigned int a_levelCount);
+	// Block compresses every level, BC5 for normal maps, otherwise BC1 or 
+	// BC3 when any texel isn't opaque. 0 threads uses every hardware thread.
+	void Compress(bool a_bNormalMap, unsigned int a_threadCount);
+	// Maps a cache, failing if it's missing, its source has changed or it was 
+	// compressed for the other kind of map. Levels are read from disk as 
+	// they're first touched.
+	bool Load(const char* a_pCacheFilename, const char* a_pSourceFilename, bool a_bNormalMap);
+	// Touches the pages of every level from the first down, so copying them 
+	// later doesn't stall on reads from disk. Returns the bytes touched.
+	size_t Prefetch(unsigned int a_firstLevel) const;
+	bool Save(const char* a_pCacheFilename, const char* a_pSourceFilename) const;
+	// Normal maps have their own cache, so an image used as both kinds of 
+	// map keeps a cache for each.
+	static std::string GetCacheFileName(const char* a_pSourceFilename, bool a_bNormalMap);
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+	unsigned int GetLevelCount() const;
+	unsigned int GetLevelWidth(unsigned int a_level) const;
+	unsigned int GetLevelHeight(unsigned int a_level) const;
+	// Largest level no more than the given texels across, 0 for the top.
+	unsigned int FindLevel(unsigned int a_maxSize) const;
+	FORMATS GetFormat() const;
+	// Levels are stored as rows of texels, or rows of 4x4 blocks when 
+	// compressed.
+	unsigned int GetRowHeight() const;
+	unsigned int GetRowCount(unsigned int a_level) const;
+	unsigned int GetRowSize(unsigned int a_level) const;
+	const unsigned char* GetLevel(unsigned int a_level) const;
+	// Writable level of an image built by Create.
+	unsigned char* GetBuiltLevel(unsigned int a_level);
+	// Bytes in every level together.
+	size_t GetSize() const;
+	// Size and XXH64 hash of the source a loaded cache was built from, read 
+	// from its header so the source isn't read again. 0 for decoded images.
+	unsigned long long GetSourceSize() const;
+	unsigned long long GetSourceHash() const;
+	// Bytes in an image of the given format and size.
+	static size_t GetImageSize(FORMATS a_format, unsigned int a_width, unsigned int a_height);
+
+private:
+	// Caches can't be shared, the mapping would be closed twice.
+	TextureCache(const TextureCache&);
+	TextureCache& operator = (const TextureCache&);
+
+	// Builds every level below the top one with a triangle filter.
+	void BuildMips();
+	// Lays out every level in the current format, returning the total size.
+	size_t LayOutLevels(unsigned int a_levelCount);
+
+	unsigned int m_uiWidth;
+	unsigned int m_uiHeight;
+	FORMATS m_format;
+	// Points into the mapped cache or the built data.
+	const unsigned char* m_pLevels;
+	// Each level's offset from the first, with one extra for the end.
+	std::vector<size_t> m_levelOffsets;
+	std::vector<unsigned char> m_builtLevels;
+	OBJMappedFile m_file;
+	unsigned long long m_sourceSize;
+	unsigned long long m_sourceHash;
+};
+
+#endif // TEXTURE_CACHE_H.
@@ -0,0 +1,79 @@
+//////////////////////////////
+// File: TextureDecoder.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef TEXTURE_DECODER_H
+#define TEXTURE_DECODER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TextureCache;
+
+/// <summary>
+/// Loads image files with their mips on a pool of worker threads. Each file's cache is mapped when it's up to date, 
+/// otherwise the file is decoded, its mips are built and compressed and the cache is written for next time. Files are queued from the 
+/// GL thread, which later collects the images and uploads them, as GL calls can't be made from the workers. A cache is only 
+/// read from disk for the levels asked for.
+/// </summary>
+class TextureDecoder
+{
+public:
+	typedef struct Image
+	{
+		std::string filename;
+		bool bNormalMap;
+		// Null when the file couldn't be decoded, otherwise owned by whoever 
+		// takes the image.
+		TextureCache* pCache;
+		// Whether the image was mapped from its cache instead of decoded.
+		bool bFromCache;
+		// Largest level asked for, its pages and those below are prefetched.
+		unsigned int firstLevel;
+		// Size and XXH64 hash of the file, taken from its cache's header 
+		// when it's up to date. Unhashed if the file couldn't be read.
+		unsigned long long fileSize;
+		unsigned long long hash;
+		bool bHashed;
+	} Image;
+
+	// 0 threads uses every hardware thread but the one queueing files.
+	TextureDecoder(unsigned int a_threadCount);
+	~TextureDecoder();
+
+	// Normal maps are compressed to two channels. Only the levels up to the 
+	// largest no more than the maximum size across are read, 0 reads all.
+	void Queue(const std::string& a_filename, bool a_bNormalMap, unsigned int a_maxSize = 0);
+	// Moves every image decoded since the last call into the list.
+	void TakeDecoded(std::vector<Image>& a_images);
+	// Files queued, being decoded or decoded but not yet taken.
+	unsigned int GetPendingCount() const;
+	unsigned int GetThreadCount() const;
+
+private:
+	typedef struct Request
+	{
+		std::string filename;
+		bool bNormalMap;
+		unsigned int maxSize;
+	} Request;
+
+	void Work();
+
+	bool m_bStopping;
+	// Files taken from the queue whose images haven't been stored yet.
+	unsigned int m_uiDecoding;
+	std::vector<std::thread> m_workers;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_queueChanged;
+	std::deque<Request> m_queue;
+	std::vector<Image> m_decoded;
+};
+
+#endif // TEXTURE_DECODER_H.
@@ -7,28 +7,121 @@
 #ifndef TEXTURE_MANAGER_H
 #define TEXTURE_MANAGER_H
 
+#include <chrono>
+#include "GLM/glm.hpp"
+#include <list>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 class Texture;
+class TextureDecoder;
+class TextureStreamer;
+class TextureTable;
 
 /// <summary>
 /// Handles loading and other management of all texture classes.
 /// Acts as a singleton object for ease of access.
+/// Files are decoded on worker threads, textures are drawn with a placeholder texel until FinalizeTextures has streamed 
+/// them in.
+/// Textures are referred to by handles rather than GL names, so their storage can be replaced. Each texture first loads 
+/// its coarse mips, then the render queue asks for the texels its draws cover on screen and larger mips are read from 
+/// the texture's cache within a per-frame load budget, or dropped once they're no longer needed. Past a GPU memory 
+/// budget the least recently used textures are demoted to their smaller mips, then evicted, and streamed back in when 
+/// drawn.
+/// Where the driver supports bindless textures every texture's handle is also kept in a texture table, updated as 
+/// textures' storage is replaced, so shaders can sample them through the material table without binds.
+/// Small textures can be packed into shared atlases, loading a packed texture loads its atlas and a UV transform to its 
+/// region.
+/// Filenames are normalized and files are identified by a hash of their contents, taken on the decode workers, so the 
+/// same image reached through different paths or copied between model folders is uploaded and kept resident once. Such 
+/// files keep their own handles, which share the first file's texture once their contents are known.
 /// </summary>
 class TextureManager
 {
 public:
+	typedef struct Statistics
+	{
+		// Textures drawn with the mips they need resident, or without, 
+		// counted once a frame.
+		unsigned int hits;
+		unsigned int misses;
+		unsigned int demotions;
+		unsigned int evictions;
+		// Loads queued to raise textures' resolution, and the bytes of mips 
+		// they read.
+		unsigned int loads;
+		size_t bytesRequested;
+		size_t residentBytes;
+		size_t peakResidentBytes;
+		// Texture table entries rewritten for textures whose storage changed.
+		unsigned int tableUpdates;
+		// Atlases packed and the textures they hold in place of their own 
+		// texture objects.
+		unsigned int atlases;
+		unsigned int atlasedTextures;
+		// Files loaded whose contents matched a loaded texture's, the bytes 
+		// of them that weren't decoded, and the most GPU bytes their copies 
+		// would have held at once.
+		unsigned int sharedTextures;
+		size_t sharedFileBytes;
+		size_t sharedResidentBytes;
+	} Statistics;
+
 	static TextureManager* CreateInstance();
 	static TextureManager* GetInstance();
 	static void DestroyInstance();
 
-	unsigned int LoadTexture(const char* a_pFilename);
-	unsigned int GetTexture(const char* a_pFilename);
-	bool TextureExists(const char* a_pTextureName);
+	// Returns the texture's handle straight away, its file is decoded in the 
+	// background. Normal maps are compressed to two channels. Textures packed 
+	// in an atlas return the atlas's handle, the UV transform is the scale 
+	// in XY and offset in ZW of their region.
+	unsigned int LoadTexture(const char* a_pFilename,
+		bool a_bNormalMap = false,
+		glm::vec4* a_pUVTransform = nullptr);
+	// Packs the small textures among the files into an atlas saved to the 
+	// manifest, those loaded afterwards share the atlas's texture. Returns 
+	// how many were packed.
+	unsigned int PackAtlas(const char* a_pAtlasFilename, const std::vector<std::string>& a_filenames);
+	// Streams decoded textures to the GPU within the upload budget and 
+	// frees textures past the memory budget. Must be called on the GL 
+	// thread, once per frame.
+	void FinalizeTextures();
+	// Marks a texture as used this frame by a draw needing the given texels 
+	// across each unit of UV. 0 asks for the full image.
+	void RequestTexture(unsigned int a_texture, float a_texelsPerUV);
+	// GL name to bind for a texture, the placeholder's if it isn't resident.
+	unsigned int GetTextureName(unsigned int a_texture) const;
+	// Draws sample textures through the texture table rather than binding 
+	// them, ignored when bindless textures are unsupported.
+	void SetBindless(bool a_bBindless);
+	bool IsBindless() const;
+	// Textures still being decoded or uploaded.
+	unsigned int GetPendingCount() const;
+	// Texture bytes uploaded per frame.
+	void SetUploadBudget(unsigned int a_bytes);
+	unsigned int GetUploadBudget() const;
+	// Bytes of mips that loads may read from disk per frame, at least one 
+	// load is queued a frame.
+	void SetLoadBudget(size_t a_bytes);
+	size_t GetLoadBudget() const;
+	// GPU bytes textures may hold before the least recently used are freed.
+	void SetResidencyBudget(size_t a_bytes);
+	size_t GetResidencyBudget() const;
+	const Statistics& GetStatistics() const;
+	unsigned int GetTexture(const char* a_pFilename, bool a_bNormalMap = false);
+	bool TextureExists(const char* a_pTextureName, bool a_bNormalMap = false);
 	void ReleaseTexture(unsigned int a_texture);
 
 private:
+	// Normalized filename and whether it's loaded as a normal map, the same 
+	// file is a different texture as each.
+	typedef std::pair<std::string, bool> FileKey;
+	// Hash of a file's contents and whether it's loaded as a normal map, 
+	// which compresses it differently.
+	typedef std::pair<unsigned long long, bool> ContentKey;
+
 	// Structure to reference count a texture.
 	typedef struct TextureReference
 	{
@@ -36,13 +129,94 @@ private:
 		// Indicates how many pointers are currently pointing to this texture.
 		// Only unload at 0 references.
 		unsigned int referenceCount;
+		bool bNormalMap;
+		// Queued to be decoded and streamed in.
+		bool bLoading;
+		unsigned int lastUsedFrame;
+		// Most texels per unit of UV asked for in the last frame used.
+		float requestedTexels;
+		// Atlases need this many times the texels their smallest member asks 
+		// for, other textures 1.
+		float texelScale;
+		// Position in the recently used list.
+		std::list<unsigned int>::iterator recentlyUsed;
+		// Storage version the texture table's entry was made from.
+		unsigned int tableVersion;
+		// Hash of the file's contents, and whether it's in the content map.
+		ContentKey contentKey;
+		bool bHashed;
+		// Distinct files with the texture's contents.
+		unsigned int fileCount;
+		// Texture drawn in place of this one when its file's contents 
+		// matched it, 0 when this holds its own texture.
+		unsigned int sharedHandle;
 	} TextureReference;
 
+	typedef struct AtlasRegion
+	{
+		std::string atlasFilename;
+		glm::vec4 uvTransform;
+	} AtlasRegion;
+
 	TextureManager();
 	~TextureManager();
 
+	// Separators become forward slashes, and empty, '.' and resolvable '..' 
+	// components are removed.
+	static std::string NormalizePath(const char* a_pFilename);
+	// Handle of the texture drawn for a handle, which differs when its file 
+	// shares another's texture.
+	unsigned int ResolveHandle(unsigned int a_texture) const;
+	// Drops a texture whose file turned out to hold the same image as 
+	// another, its handle draws the other's texture from then on.
+	void ShareTexture(unsigned int a_texture, unsigned int a_sharedTexture, unsigned long long a_fileSize);
+	// Queues a file's levels up to the maximum size to be decoded, starting a 
+	// new batch if nothing is pending.
+	void QueueDecode(const std::string& a_filename, bool a_bNormalMap, unsigned int a_maxSize);
+	// Smallest level of a loaded texture with at least the requested texels 
+	// across.
+	unsigned int GetWantedLevel(const TextureReference& a_textureReference) const;
+	// Queues loads for textures drawn last frame without the mips they need, 
+	// those furthest from them first, and demotes those with more than 
+	// they need.
+	void UpdateResolutions();
+	// Demotes then evicts the least recently used textures until the 
+	// resident bytes fit the budget. Textures used last frame are kept.
+	void EnforceResidencyBudget();
+	// Points the texture table's entries at the names textures hold after 
+	// this frame's uploads, demotions and evictions.
+	void UpdateTextureTable();
+
+	// Textures are first loaded at, and aren't demoted below, this many 
+	// texels across.
+	static const unsigned int ms_uiCoarseSize;
+	// Table version of textures whose entry must be written again.
+	static const unsigned int ms_uiUnwrittenVersion;
 	static TextureManager* m_poInstance;
-	std::map<std::string, TextureReference> m_pTextureMap;
+	// Handles index the references from 1, 0 is no texture. Each file 
+	// sharing a texture has an entry.
+	std::map<FileKey, unsigned int> m_pTextureMap;
+	std::map<ContentKey, unsigned int> m_contentMap;
+	// Regions of the textures packed into atlases, by normalized filename.
+	std::map<std::string, AtlasRegion> m_atlasRegions;
+	std::vector<TextureReference> m_textures;
+	std::vector<unsigned int> m_freeHandles;
+	// Handles of live textures, most recently used first.
+	std::list<unsigned int> m_recentlyUsed;
+	Texture* m_poPlaceholder;
+	TextureDecoder* m_poDecoder;
+	TextureStreamer* m_poStreamer;
+	TextureTable* m_poTextureTable;
+	bool m_bBindless;
+	size_t m_loadBudget;
+	size_t m_residencyBudget;
+	unsigned int m_uiFrame;
+	Statistics m_statistics;
+	// Textures queued since the decoder was last idle, how many of them 
+	// were mapped from a cache, and when the first of them was queued.
+	unsigned int m_uiBatchTextures;
+	unsigned int m_uiBatchCached;
+	std::chrono::high_resolution_clock::time_point m_batchStart;
 };
 
 #endif // !TEXTURE_MANAGER_H.
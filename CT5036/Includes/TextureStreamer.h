@@ -0,0 +1,90 @@
+//////////////////////////////
+// File: TextureStreamer.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#ifdef WIN64
+#include "GLAD/glad.h"
+#endif // WIN64.
+#include <deque>
+#include <vector>
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+
+class Texture;
+class TextureCache;
+
+/// <summary>
+/// Uploads textures and their mips through a ring of persistently mapped pixel buffer segments, a few rows at a time. Each 
+/// frame fills the next segment up to a byte budget and fences it, so the copy into a texture never waits on the GPU 
+/// and a large texture is spread across frames instead of stalling one.
+/// </summary>
+class TextureStreamer
+{
+public:
+	typedef struct Statistics
+	{
+		unsigned int bytesUploaded;
+		unsigned int texturesCompleted;
+		// Frames the next segment was still being read by the GPU.
+		unsigned int segmentsBusy;
+	} Statistics;
+
+	TextureStreamer();
+	~TextureStreamer();
+
+	// Queues a texture's mips from the first level down, the cache is 
+	// deleted once they're uploaded. Levels the texture already holds are 
+	// copied on the GPU instead.
+	void Queue(Texture* a_pTexture, TextureCache* a_pCache, unsigned int a_firstLevel);
+	// Drops a texture's queued upload, for textures about to be deleted or 
+	// evicted. Returns whether there was one.
+	bool Cancel(const Texture* a_pTexture);
+	// Uploads up to the budget's worth of queued rows. Must be called on the 
+	// GL thread, once per frame.
+	void Update();
+	// Bytes uploaded per frame, at most one segment's size.
+	void SetBudget(unsigned int a_bytes);
+	unsigned int GetBudget() const;
+	// Textures with rows still to upload.
+	unsigned int GetPendingCount() const;
+	// Moves every texture committed since the last call into the list.
+	void TakeCompleted(std::vector<Texture*>& a_textures);
+	// Counters for the last Update call.
+	const Statistics& GetFrameStatistics() const;
+
+private:
+	typedef struct Upload
+	{
+		Texture* pTexture;
+		TextureCache* pCache;
+		// First row of the level that hasn't been copied into a segment yet.
+		unsigned int level;
+		unsigned int nextRow;
+		// Level the texture's resident mips start at, known once its storage 
+		// is allocated.
+		unsigned int endLevel;
+		bool bAllocated;
+	} Upload;
+
+	static const unsigned int ms_uiSegmentCount = 4;
+	static const unsigned int ms_uiSegmentSize;
+
+	unsigned int m_uiBuffer;
+	unsigned int m_uiBudget;
+	// Segment the next Update fills.
+	unsigned int m_uiSegment;
+	unsigned char* m_pMappedBuffer;
+	// Signalled once the GPU has finished reading each segment.
+	GLsync m_fences[ms_uiSegmentCount];
+	std::deque<Upload> m_uploads;
+	std::vector<Texture*> m_completed;
+	Statistics m_frameStatistics;
+};
+
+#endif // TEXTURE_STREAMER_H.
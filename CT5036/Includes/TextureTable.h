@@ -0,0 +1,85 @@
+//////////////////////////////
+// File: TextureTable.h.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#ifndef TEXTURE_TABLE_H
+#define TEXTURE_TABLE_H
+
+#ifdef WIN64
+#include "GLAD/glad.h"
+#endif // WIN64.
+#include <deque>
+#include <vector>
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+
+/// <summary>
+/// Storage buffer of ARB_bindless_texture handles indexed by texture manager handle, so shaders sample every texture 
+/// through the material table without any being bound. Each entry is made from a texture view, which keeps the mips 
+/// alive after the texture replaces or frees its name, and views are only released once a fence shows the GPU has 
+/// finished the frames that could read them. Entries without a texture sample the placeholder.
+/// </summary>
+class TextureTable
+{
+public:
+	TextureTable();
+	~TextureTable();
+
+	// Loads the extension's entry points and makes the placeholder's handle, 
+	// false when the driver doesn't support bindless textures. Must be 
+	// called on the GL thread.
+	bool Create(unsigned int a_placeholder);
+	bool IsSupported() const;
+	// Points an entry at a texture's resident mips, or at the placeholder 
+	// when the name is 0. The table grows to fit the index.
+	void Set(unsigned int a_index,
+		unsigned int a_name,
+		unsigned int a_internalFormat,
+		unsigned int a_levelCount);
+	// Copies changed entries to the buffer and frees views the GPU has 
+	// finished with. Called once per frame before drawing.
+	void Update();
+	void Bind() const;
+	// Entries changed since the table was created.
+	unsigned int GetUpdateCount() const;
+
+private:
+	typedef struct Entry
+	{
+		// View of the texture's mips, 0 for the placeholder.
+		unsigned int view;
+		GLuint64 handle;
+	} Entry;
+
+	// Views replaced in the same frame share a fence.
+	typedef struct RetiredViews
+	{
+		GLsync fence;
+		std::vector<Entry> entries;
+	} RetiredViews;
+
+	// Makes the entry's handle non-resident and deletes its view.
+	void Release(const Entry& a_entry) const;
+
+	bool m_bSupported;
+	unsigned int m_uiBuffer;
+	// Entries the buffer has room for.
+	unsigned int m_uiCapacity;
+	// Sampling state shared by every handle.
+	unsigned int m_uiSampler;
+	unsigned int m_uiUpdateCount;
+	// Range of entries changed since the last Update.
+	unsigned int m_uiFirstDirty;
+	unsigned int m_uiEndDirty;
+	GLuint64 m_placeholderHandle;
+	std::vector<Entry> m_entries;
+	// Handles in the layout the shaders read, one per entry.
+	std::vector<GLuint64> m_handles;
+	std::vector<Entry> m_retiring;
+	std::deque<RetiredViews> m_retired;
+};
+
+#endif // TEXTURE_TABLE_H.
@@ -5,22 +5,76 @@
 //////////////////////////////
 
 #version 460
+// Textures are sampled through the texture table when the driver supports 
+// it, otherwise from the units the render queue binds.
+#extension GL_ARB_bindless_texture : enable
 
 smooth in vec4 vertexPosition;
 smooth in vec4 vertexNormal;
 smooth in vec2 vertexUV;
+flat in uint vertexMaterialIndex;
 
 out vec4 outputColour;
 
-uniform vec4 cameraPosition;
-uniform vec4 kA;
-uniform vec4 kD;
-uniform vec4 kS;
+// Per frame camera data, see ShaderConstants::FrameConstants.
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 projectionViewMatrix;
+	vec4 cameraPosition;
+};
+
+// See ShaderConstants::MaterialConstants.
+struct Material
+{
+	vec4 kA;
+	vec4 kD;
+	vec4 kS;
+	// Texture table rows of the diffuse, specular and normal maps.
+	uvec4 textures;
+	// Scale in XY and offset in ZW of each map's region of its atlas.
+	vec4 uvTransforms[3];
+};
+
+// Every loaded material, uploaded once at load.
+layout(std430, binding = 1) readonly buffer MaterialTable
+{
+	Material materials[];
+};
 
 uniform sampler2D diffuseTexture;
 uniform sampler2D specularTexture;
 uniform sampler2D normalTexture;
 
+#ifdef GL_ARB_bindless_texture
+// Bindless handles indexed by texture manager handle, see TextureTable.
+layout(std430, binding = 5) readonly buffer TextureTable
+{
+	uvec2 textureHandles[];
+};
+
+// Set by the render queue when textures aren't bound.
+uniform bool bindlessTextures;
+#endif // GL_ARB_bindless_texture.
+
+// The material index comes from gl_DrawID, so the handle is the same for 
+// every fragment of a draw. Atlased textures repeat within their region, 
+// with gradients taken before wrapping so mips don't jump at the seams.
+vec4 SampleTexture(sampler2D boundTexture, uint tableRow, vec4 uvTransform, vec2 uv)
+{
+	vec2 atlasUV = uvTransform.zw + fract(uv) * uvTransform.xy;
+	vec2 uvDX = dFdx(uv) * uvTransform.xy;
+	vec2 uvDY = dFdy(uv) * uvTransform.xy;
+
+#ifdef GL_ARB_bindless_texture
+	if (bindlessTextures)
+	{
+		return textureGrad(sampler2D(textureHandles[tableRow]), atlasUV, uvDX, uvDY);
+	}
+#endif // GL_ARB_bindless_texture.
+
+	return textureGrad(boundTexture, atlasUV, uvDX, uvDY);
+}
+
 vec3 iA = vec3(0.25f, 0.25f, 0.25f);
 vec3 iD = vec3(1.f, 1.f, 1.f);
 vec3 iS = vec3(1.f, 1.f, 1.f);
@@ -29,11 +83,29 @@ vec4 lightDirection = normalize(vec4(0.f) - vec4(10.f, 8.f, 10.f, 0.f));
 
 void main()
 {
+	vec4 kA = materials[vertexMaterialIndex].kA;
+	vec4 kD = materials[vertexMaterialIndex].kD;
+	vec4 kS = materials[vertexMaterialIndex].kS;
+	uvec4 textures = materials[vertexMaterialIndex].textures;
+	vec4 diffuseTransform = materials[vertexMaterialIndex].uvTransforms[0];
+	vec4 specularTransform = materials[vertexMaterialIndex].uvTransforms[1];
+	vec4 normalTransform = materials[vertexMaterialIndex].uvTransforms[2];
 	// Get texture data from UV coordinates by storing the texture's texel 
 	// data at point vertexUV in sampler2D normalTexture.
-	vec4 normalData = texture(normalTexture, vertexUV);
-	vec4 diffuseData = texture(diffuseTexture, vertexUV);
-	vec4 specularData = texture(specularTexture, vertexUV);
+	// Normal maps are stored as X and Y only, Z is rebuilt from them. 
+	// Materials without one have no table row and get no ambient light, 
+	// rather than rebuilding a normal from the placeholder's white texel.
+	vec4 normalData = vec4(0.f, 0.f, 0.f, 1.f);
+
+	if (textures.z != 0)
+	{
+		vec2 normalXY = SampleTexture(normalTexture, textures.z, normalTransform, vertexUV).rg * 2.f - 1.f;
+		float normalZ = sqrt(max(0.f, 1.f - dot(normalXY, normalXY)));
+		normalData = vec4(vec3(normalXY, normalZ) * 0.5f + 0.5f, 1.f);
+	}
+
+	vec4 diffuseData = SampleTexture(diffuseTexture, textures.x, diffuseTransform, vertexUV);
+	vec4 specularData = SampleTexture(specularTexture, textures.y, specularTransform, vertexUV);
 	vec3 ambientLight = kA.xyz * iA * normalData.rgb;
 	
 	float negativeLightDirection = max(0.f, dot(normalize(vertexNormal), -lightDirection));
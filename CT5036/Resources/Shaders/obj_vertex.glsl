@@ -6,6 +6,9 @@
 
 #version 460
 
+// Fed by either OBJVertex or OBJPackedVertex. Packed positions only have 
+// xyz so w defaults to 1, packed normals arrive as normalized 10:10:10:2 
+// with w of 0 and packed UVs as half floats.
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec4 normal;
 layout(location = 2) in vec2 uvCoord;
@@ -13,14 +16,46 @@ layout(location = 2) in vec2 uvCoord;
 smooth out vec4 vertexPosition;
 smooth out vec4 vertexNormal;
 smooth out vec2 vertexUV;
+flat out uint vertexMaterialIndex;
 
-uniform mat4 projectionViewMatrix;
-uniform mat4 modelMatrix;
+// Per frame camera data, see ShaderConstants::FrameConstants.
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 projectionViewMatrix;
+	vec4 cameraPosition;
+};
+
+// Per instance world matrices, see InstanceBuffer.
+layout(std430, binding = 2) readonly buffer InstanceTransforms
+{
+	mat4 instanceMatrices[];
+};
+
+// Instance buffer index of each instance that passed culling, see 
+// FrustumCuller. Draws' instance ranges index this list.
+layout(std430, binding = 4) readonly buffer VisibleInstances
+{
+	uint visibleInstances[];
+};
+
+// Material index of each draw the render queue submitted this frame.
+layout(std430, binding = 3) readonly buffer DrawMaterials
+{
+	uint drawMaterialIndices[];
+};
+
+// Index of the current call's first draw, gl_DrawID counts from it.
+uniform uint drawOffset;
 
 void main()
 {
+	vertexMaterialIndex = drawMaterialIndices[drawOffset + gl_DrawID];
+	// gl_InstanceID doesn't include the draw's base instance.
+	mat4 modelMatrix = instanceMatrices[visibleInstances[gl_BaseInstance + gl_InstanceID]];
 	vertexUV = uvCoord;
-	vertexNormal = normal;
+	// Instances are only rotated and moved, so their rotation turns the 
+	// normal into world space.
+	vertexNormal = vec4(mat3(modelMatrix) * normal.xyz, 0.f);
 	// World-space position.
 	vertexPosition = modelMatrix * position;
 	// Screen-space position.
@@ -11,7 +11,12 @@ layout(location = 1) in vec4 colour;
 
 smooth out vec4 vertexColour;
 
-uniform mat4 projectionViewMatrix;
+// Per frame camera data, see ShaderConstants::FrameConstants.
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 projectionViewMatrix;
+	vec4 cameraPosition;
+};
 
 void main()
 {
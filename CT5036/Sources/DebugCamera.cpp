@@ -151,27 +151,6 @@ void DebugCamera::UpdateProjectionView()
 {
 	glm::mat4 viewMatrix = glm::inverse(m_cameraMatrix);
 	m_projectionViewMatrix = m_projectionMatrix * viewMatrix;
-	// Send the projection matrix to the vertex shader.
-	// Ask the shader program for the location of the projection-view-
-	// matrix uniform variable.
-	int projectionViewUniformLocation = glGetUniformLocation(m_poParentRenderer->GetProgram(),
-		"projectionViewMatrix");
-	const GLsizei elementsToModify = 1;
-	// Send this location a pointer to our glm::mat4 (send across float data).
-	glUniformMatrix4fv(projectionViewUniformLocation,
-		elementsToModify,
-		false,
-		glm::value_ptr(m_projectionViewMatrix));
-}
-
-void DebugCamera::UpdateCameraPosition()
-{
-	int cameraPositionUniformLocation = glGetUniformLocation(m_poParentRenderer->GetProgram(),
-		"cameraPosition");
-	const GLsizei elementsToModify = 1;
-	glUniform4fv(cameraPositionUniformLocation,
-		elementsToModify,
-		glm::value_ptr(m_cameraMatrix[3]));
 }
 
 glm::mat4 DebugCamera::GetCameraMatrix() const
@@ -182,4 +161,9 @@ glm::mat4 DebugCamera::GetCameraMatrix() const
 glm::mat4 DebugCamera::GetProjectionMatrix() const
 {
 	return m_projectionMatrix;
+}
+
+glm::mat4 DebugCamera::GetProjectionViewMatrix() const
+{
+	return m_projectionViewMatrix;
 }
\ No newline at end of file
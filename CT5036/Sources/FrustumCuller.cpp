@@ -0,0 +1,417 @@
+//////////////////////////////
+// File: FrustumCuller.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "FrustumCuller.h" // File's header.
+#include <algorithm>
+#include <cstring>
+#ifdef WIN64
+#include "GLAD/glad.h"
+#include <xmmintrin.h>
+#endif // WIN64.
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+#include "GeometryStore.h"
+#include "InstanceBuffer.h"
+#include "ShaderConstants.h"
+
+// Instances closer than this, or around the camera, ask for textures as if 
+// they were this far away.
+static const float sc_fMinTextureDepth = 0.1f;
+
+FrustumCuller::FrustumCuller(const GeometryStore* a_pGeometryStore,
+	const InstanceBuffer* a_pInstanceBuffer) : m_bEnabled(true),
+	m_bTransformsChanged(false),
+	m_uiVisibleBuffer(0),
+	m_uiVisibleCapacity(0),
+	m_planeX(),
+	m_planeY(),
+	m_planeZ(),
+	m_planeW(),
+	m_planes(),
+	m_depthRow(0.f),
+	m_fPixelsPerUnit(0.f),
+	m_pGeometryStore(a_pGeometryStore),
+	m_pInstanceBuffer(a_pInstanceBuffer),
+	m_items(),
+	m_bvhItems(),
+	m_itemSpheres(),
+	m_sphereX(),
+	m_sphereY(),
+	m_sphereZ(),
+	m_sphereRadius(),
+	m_sphereUVDensities(),
+	m_sphereInstances(),
+	m_sphereItems(),
+	m_sphereBoxes(),
+	m_bvh(),
+	m_inside(),
+	m_intersecting(),
+	m_testX(),
+	m_testY(),
+	m_testZ(),
+	m_testRadius(),
+	m_visible(),
+	m_visibleInstances(),
+	m_frameStatistics()
+{}
+
+FrustumCuller::~FrustumCuller()
+{
+	const GLsizei toDelete = 1;
+	glDeleteBuffers(toDelete, &m_uiVisibleBuffer);
+}
+
+// Extracts the inward facing, normalized planes of a projection-view 
+// matrix's frustum.
+void FrustumCuller::ExtractPlanes(const glm::mat4& a_projectionViewMatrix, glm::vec4* a_pPlanes)
+{
+	// Each plane is the matrix's last row plus or minus one of the others 
+	// (Gribb and Hartmann). GLM matrices are column major.
+	const glm::mat4& m = a_projectionViewMatrix;
+	glm::vec4 rows[4];
+
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		rows[row] = glm::vec4(m[0][row], m[1][row], m[2][row], m[3][row]);
+	}
+
+	a_pPlanes[PLANES_LEFT] = rows[3] + rows[0];
+	a_pPlanes[PLANES_RIGHT] = rows[3] - rows[0];
+	a_pPlanes[PLANES_BOTTOM] = rows[3] + rows[1];
+	a_pPlanes[PLANES_TOP] = rows[3] - rows[1];
+	a_pPlanes[PLANES_NEAR] = rows[3] + rows[2];
+	a_pPlanes[PLANES_FAR] = rows[3] - rows[2];
+
+	for (unsigned int plane = 0; plane < PLANES_COUNT; ++plane)
+	{
+		// Normalized planes give true distances to compare radii against.
+		a_pPlanes[plane] /= glm::length(glm::vec3(a_pPlanes[plane]));
+	}
+}
+
+// Extracts the frustum's planes and clears the last frame's draws. The BVH 
+// is only refitted when instance transforms have changed.
+void FrustumCuller::Begin(const glm::mat4& a_projectionViewMatrix, bool a_bTransformsChanged, float a_viewportHeight)
+{
+	ExtractPlanes(a_projectionViewMatrix, m_planes);
+	// The view's rotation leaves the projection's vertical scale as the 
+	// length of the second row.
+	const glm::mat4 rows = glm::transpose(a_projectionViewMatrix);
+	m_depthRow = rows[3];
+	m_fPixelsPerUnit = glm::length(glm::vec3(rows[1])) * a_viewportHeight * 0.5f;
+
+	for (unsigned int plane = 0; plane < PLANES_COUNT; ++plane)
+	{
+		m_planeX[plane] = m_planes[plane].x;
+		m_planeY[plane] = m_planes[plane].y;
+		m_planeZ[plane] = m_planes[plane].z;
+		m_planeW[plane] = m_planes[plane].w;
+	}
+
+	m_bTransformsChanged = a_bTransformsChanged;
+	m_items.clear();
+}
+
+// Queues a draw, its instances' transforms must already be set.
+void FrustumCuller::Add(const RenderQueue::DrawItem& a_item)
+{
+	m_items.push_back(a_item);
+}
+
+// Tests every queued instance and submits each draw that has visible 
+// instances.
+void FrustumCuller::Submit(RenderQueue* a_pRenderQueue)
+{
+	m_frameStatistics = Statistics();
+	// The same draws as last frame keep the BVH's shape, otherwise the 
+	// instances it holds have changed and it must be rebuilt.
+	const bool bSameItems = m_items.size() == m_bvhItems.size() &&
+		(m_items.empty() ||
+		memcmp(m_items.data(), m_bvhItems.data(), m_items.size() * sizeof(RenderQueue::DrawItem)) == 0);
+
+	if (!bSameItems || m_bTransformsChanged)
+	{
+		UpdateBounds(!bSameItems);
+	}
+
+	const size_t sphereCount = m_sphereInstances.size();
+	m_visible.assign(sphereCount, m_bEnabled ? 0 : 1);
+
+	if (m_bEnabled)
+	{
+		m_inside.clear();
+		m_intersecting.clear();
+		m_bvh.QueryFrustum(m_planes, PLANES_COUNT, m_inside, m_intersecting);
+
+		for (auto iterator = m_inside.begin(); iterator != m_inside.end(); ++iterator)
+		{
+			m_visible[*iterator] = 1;
+		}
+
+		TestSpheres();
+	}
+
+	m_visibleInstances.clear();
+
+	for (unsigned int item = 0; item < m_items.size(); ++item)
+	{
+		RenderQueue::DrawItem visibleItem = m_items[item];
+		visibleItem.firstInstance = (unsigned int)m_visibleInstances.size();
+		visibleItem.texelsPerUV = 0.f;
+
+		for (unsigned int i = 0; i < m_items[item].instanceCount; ++i)
+		{
+			const unsigned int sphere = m_itemSpheres[item] + i;
+
+			if (m_visible[sphere])
+			{
+				m_visibleInstances.push_back(m_sphereInstances[sphere]);
+				// The sphere's nearest point sets the most texels it needs.
+				const float depth = glm::dot(m_depthRow,
+					glm::vec4(m_sphereX[sphere], m_sphereY[sphere], m_sphereZ[sphere], 1.f)) - m_sphereRadius[sphere];
+				visibleItem.texelsPerUV = std::max(visibleItem.texelsPerUV,
+					m_sphereUVDensities[sphere] * m_fPixelsPerUnit / std::max(depth, sc_fMinTextureDepth));
+			}
+		}
+
+		visibleItem.instanceCount = (unsigned int)m_visibleInstances.size() - visibleItem.firstInstance;
+		m_frameStatistics.instancesVisible += visibleItem.instanceCount;
+		m_frameStatistics.instancesCulled += m_items[item].instanceCount - visibleItem.instanceCount;
+
+		if (visibleItem.instanceCount == 0)
+		{
+			++m_frameStatistics.drawsCulled;
+			continue;
+		}
+
+		++m_frameStatistics.drawsVisible;
+		a_pRenderQueue->Submit(visibleItem);
+	}
+
+	UploadVisibleInstances();
+}
+
+// Finds the instances from the last Submit whose bounds the ray passes 
+// through, nearest first. Culled instances are included.
+void FrustumCuller::QueryRay(const glm::vec3& a_origin,
+	const glm::vec3& a_direction,
+	float a_maxDistance,
+	std::vector<RayCandidate>& a_candidates) const
+{
+	a_candidates.clear();
+
+	if (m_sphereInstances.empty())
+	{
+		return;
+	}
+
+	std::vector<SceneBVH::RayHit> hits;
+	m_bvh.QueryRay(a_origin, a_direction, a_maxDistance, hits);
+	a_candidates.reserve(hits.size());
+
+	for (auto iterator = hits.begin(); iterator != hits.end(); ++iterator)
+	{
+		// The spheres were last fitted for the BVH's draws, which may 
+		// differ from the draws queued since Begin.
+		RayCandidate candidate;
+		candidate.geometryHandle = m_bvhItems[m_sphereItems[iterator->item]].geometryHandle;
+		candidate.instance = m_sphereInstances[iterator->item];
+		candidate.distance = iterator->distance;
+		a_candidates.push_back(candidate);
+	}
+}
+
+// Binds the visible instance list to its binding point.
+void FrustumCuller::Bind() const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ShaderConstants::BINDINGS_VISIBLE_INSTANCES, m_uiVisibleBuffer);
+}
+
+// Disabled culling treats every instance as visible.
+void FrustumCuller::SetEnabled(bool a_enabled)
+{
+	m_bEnabled = a_enabled;
+}
+
+bool FrustumCuller::IsEnabled() const
+{
+	return m_bEnabled;
+}
+
+// Counters for the last Submit call.
+const FrustumCuller::Statistics& FrustumCuller::GetFrameStatistics() const
+{
+	return m_frameStatistics;
+}
+
+// Fits world space spheres around every queued instance and rebuilds or 
+// refits the BVH over them.
+void FrustumCuller::UpdateBounds(bool a_bRebuild)
+{
+	m_itemSpheres.clear();
+	m_sphereX.clear();
+	m_sphereY.clear();
+	m_sphereZ.clear();
+	m_sphereRadius.clear();
+	m_sphereUVDensities.clear();
+	m_sphereInstances.clear();
+	m_sphereItems.clear();
+	m_sphereBoxes.clear();
+
+	for (auto iterator = m_items.begin(); iterator != m_items.end(); ++iterator)
+	{
+		const GeometryStore::MeshRange& range = m_pGeometryStore->GetMeshRange(iterator->geometryHandle);
+		const glm::vec4& sphere = range.boundingSphere;
+		const glm::vec4 centre(sphere.x, sphere.y, sphere.z, 1.f);
+		m_itemSpheres.push_back((unsigned int)m_sphereInstances.size());
+
+		for (unsigned int i = 0; i < iterator->instanceCount; ++i)
+		{
+			const unsigned int instance = iterator->firstInstance + i;
+			const glm::mat4& transform = m_pInstanceBuffer->GetTransform(instance);
+			const glm::vec4 worldCentre = transform * centre;
+			// Scaling can stretch the sphere, so cover its largest axis.
+			const float scale = std::max(glm::length(glm::vec3(transform[0])),
+				std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+			const float radius = sphere.w * scale;
+			m_sphereX.push_back(worldCentre.x);
+			m_sphereY.push_back(worldCentre.y);
+			m_sphereZ.push_back(worldCentre.z);
+			m_sphereRadius.push_back(radius);
+			m_sphereUVDensities.push_back(range.uvDensity * scale);
+			m_sphereInstances.push_back(instance);
+			m_sphereItems.push_back((unsigned int)(iterator - m_items.begin()));
+			SceneBVH::Box box;
+			box.min = glm::vec3(worldCentre) - glm::vec3(radius);
+			box.max = glm::vec3(worldCentre) + glm::vec3(radius);
+			m_sphereBoxes.push_back(box);
+		}
+	}
+
+	if (a_bRebuild)
+	{
+		m_bvh.Build(m_sphereBoxes);
+		m_bvhItems = m_items;
+		m_frameStatistics.bBVHRebuilt = true;
+	}
+	else
+	{
+		m_bvh.Refit(m_sphereBoxes);
+		m_frameStatistics.bBVHRefitted = true;
+	}
+}
+
+// Sets m_visible for each sphere listed in m_intersecting.
+void FrustumCuller::TestSpheres()
+{
+	// Gather the spheres so they can be loaded four at a time. Padding 
+	// spheres keep the tests in whole batches, their results are never read.
+	const size_t sphereCount = m_intersecting.size();
+	const size_t paddedCount = (sphereCount + 3) & ~(size_t)3;
+	m_testX.resize(paddedCount);
+	m_testY.resize(paddedCount);
+	m_testZ.resize(paddedCount);
+	m_testRadius.resize(paddedCount);
+	m_frameStatistics.spheresTested = (unsigned int)sphereCount;
+
+	for (size_t i = 0; i < paddedCount; ++i)
+	{
+		const unsigned int sphere = i < sphereCount ? m_intersecting[i] : 0;
+		m_testX[i] = i < sphereCount ? m_sphereX[sphere] : 0.f;
+		m_testY[i] = i < sphereCount ? m_sphereY[sphere] : 0.f;
+		m_testZ[i] = i < sphereCount ? m_sphereZ[sphere] : 0.f;
+		m_testRadius[i] = i < sphereCount ? m_sphereRadius[sphere] : 0.f;
+	}
+
+#ifdef WIN64
+	// A sphere is outside when its centre is further than its radius behind 
+	// any plane. Four spheres are tested against each plane at once.
+	__m128 planeX[PLANES_COUNT];
+	__m128 planeY[PLANES_COUNT];
+	__m128 planeZ[PLANES_COUNT];
+	__m128 planeW[PLANES_COUNT];
+
+	for (unsigned int plane = 0; plane < PLANES_COUNT; ++plane)
+	{
+		planeX[plane] = _mm_set1_ps(m_planeX[plane]);
+		planeY[plane] = _mm_set1_ps(m_planeY[plane]);
+		planeZ[plane] = _mm_set1_ps(m_planeZ[plane]);
+		planeW[plane] = _mm_set1_ps(m_planeW[plane]);
+	}
+
+	for (size_t i = 0; i < paddedCount; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(&m_testX[i]);
+		const __m128 y = _mm_loadu_ps(&m_testY[i]);
+		const __m128 z = _mm_loadu_ps(&m_testZ[i]);
+		const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&m_testRadius[i]));
+		__m128 inside = _mm_cmpeq_ps(x, x);
+
+		for (unsigned int plane = 0; plane < PLANES_COUNT; ++plane)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[plane], x), planeW[plane]);
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeY[plane], y));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeZ[plane], z));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+		}
+
+		const int mask = _mm_movemask_ps(inside);
+
+		for (size_t lane = 0; lane < 4 && i + lane < sphereCount; ++lane)
+		{
+			m_visible[m_intersecting[i + lane]] = (unsigned char)((mask >> lane) & 1);
+		}
+	}
+#else
+	for (size_t i = 0; i < sphereCount; ++i)
+	{
+		bool bInside = true;
+
+		for (unsigned int plane = 0; plane < PLANES_COUNT && bInside; ++plane)
+		{
+			const float distance = m_planeX[plane] * m_testX[i] +
+				m_planeY[plane] * m_testY[i] +
+				m_planeZ[plane] * m_testZ[i] +
+				m_planeW[plane];
+			bInside = distance >= -m_testRadius[i];
+		}
+
+		m_visible[m_intersecting[i]] = bInside ? 1 : 0;
+	}
+#endif // WIN64.
+}
+
+void FrustumCuller::UploadVisibleInstances()
+{
+	const unsigned int visibleCount = (unsigned int)m_visibleInstances.size();
+
+	if (visibleCount == 0)
+	{
+		return;
+	}
+
+	if (visibleCount > m_uiVisibleCapacity)
+	{
+		// Immutable storage can't grow, so replace it with room to spare.
+		const GLsizei buffers = 1;
+		glDeleteBuffers(buffers, &m_uiVisibleBuffer);
+		glGenBuffers(buffers, &m_uiVisibleBuffer);
+		m_uiVisibleCapacity = std::max(visibleCount, m_uiVisibleCapacity * 2);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiVisibleBuffer);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER,
+			m_uiVisibleCapacity * sizeof(unsigned int),
+			nullptr,
+			GL_DYNAMIC_STORAGE_BIT);
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiVisibleBuffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+		0,
+		visibleCount * sizeof(unsigned int),
+		m_visibleInstances.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
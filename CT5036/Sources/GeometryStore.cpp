@@ -0,0 +1,220 @@
+//////////////////////////////
+// File: GeometryStore.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "GeometryStore.h" // File's header.
+#include <iostream>
+#include "OBJLoader.h"
+
+GeometryStore::GeometryStore(bool a_packedVertices) : m_bPackedVertices(a_packedVertices),
+	m_bUploaded(false),
+	m_uiVAO(0),
+	m_uiVertexBuffer(0),
+	m_uiIndexBuffer(0),
+	m_uiVertexStride(a_packedVertices ? sizeof(OBJPackedVertex) : sizeof(OBJVertex)),
+	m_uiVertexCount(0),
+	m_uiIndexCount(0),
+	m_meshRanges(),
+	m_pendingMeshes()
+{}
+
+GeometryStore::~GeometryStore()
+{
+	const GLsizei toDelete = 1;
+	glDeleteBuffers(toDelete, &m_uiVertexBuffer);
+	glDeleteBuffers(toDelete, &m_uiIndexBuffer);
+	glDeleteVertexArrays(toDelete, &m_uiVAO);
+}
+
+// Reserves space for a mesh. Its data is read when Upload is called so the 
+// mesh must stay alive until then.
+bool GeometryStore::AddMesh(OBJMesh* a_pMesh, unsigned int& a_handle)
+{
+	// Immutable storage can't grow once it's been created.
+	if (m_bUploaded)
+	{
+		std::cout << "Error: Meshes can't be added to the geometry store after uploading." << std::endl;
+		return false;
+	}
+
+	// Every mesh shares the store's vertex layout.
+	if (a_pMesh->IsPacked() != m_bPackedVertices)
+	{
+		std::cout << "Error: Mesh " << a_pMesh->GetName() <<
+			" doesn't match the geometry store's vertex format." << std::endl;
+		return false;
+	}
+
+	MeshRange range;
+	range.firstIndex = m_uiIndexCount;
+	range.indexCount = (unsigned int)a_pMesh->GetIndices()->size();
+	range.baseVertex = (int)m_uiVertexCount;
+	range.vertexCount = (unsigned int)(m_bPackedVertices ?
+		a_pMesh->GetPackedVertices()->size() :
+		a_pMesh->GetVertices()->size());
+	range.boundingSphere = a_pMesh->GetBoundingSphere();
+	range.uvDensity = a_pMesh->GetUVDensity();
+	m_uiIndexCount += range.indexCount;
+	m_uiVertexCount += range.vertexCount;
+	a_handle = (unsigned int)m_meshRanges.size();
+	m_meshRanges.push_back(range);
+	m_pendingMeshes.push_back(a_pMesh);
+	return true;
+}
+
+// Creates the buffers and copies every added mesh into them.
+bool GeometryStore::Upload()
+{
+	if (m_bUploaded)
+	{
+		return false;
+	}
+
+	const GLsizei toGenerate = 1;
+	glGenVertexArrays(toGenerate, &m_uiVAO);
+	glGenBuffers(toGenerate, &m_uiVertexBuffer);
+	glGenBuffers(toGenerate, &m_uiIndexBuffer);
+	glBindVertexArray(m_uiVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, m_uiVertexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiIndexBuffer);
+	// Storage is sized once for every mesh and only written to here.
+	const GLsizeiptr vertexBytes = (GLsizeiptr)m_uiVertexCount * m_uiVertexStride;
+	const GLsizeiptr indexBytes = (GLsizeiptr)m_uiIndexCount * sizeof(unsigned int);
+	glBufferStorage(GL_ARRAY_BUFFER, vertexBytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, indexBytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	for (unsigned int i = 0; i < m_pendingMeshes.size(); ++i)
+	{
+		OBJMesh* pMesh = m_pendingMeshes[i];
+		const MeshRange& range = m_meshRanges[i];
+		const void* pVertices = m_bPackedVertices ?
+			(const void*)pMesh->GetPackedVertices()->data() :
+			(const void*)pMesh->GetVertices()->data();
+		glBufferSubData(GL_ARRAY_BUFFER,
+			(GLintptr)range.baseVertex * m_uiVertexStride,
+			(GLsizeiptr)range.vertexCount * m_uiVertexStride,
+			pVertices);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+			(GLintptr)range.firstIndex * sizeof(unsigned int),
+			(GLsizeiptr)range.indexCount * sizeof(unsigned int),
+			pMesh->GetIndices()->data());
+	}
+
+	SetupVertexAttributes();
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	m_pendingMeshes.clear();
+	m_bUploaded = true;
+	const unsigned int kilobyte = 1024;
+	std::cout << "Geometry store: " << m_meshRanges.size() << " meshes, " <<
+		vertexBytes / kilobyte << " KB vertices, " <<
+		indexBytes / kilobyte << " KB indices." << std::endl;
+	return true;
+}
+
+// Draws instances of a mesh, the store's VAO must be bound. The first 
+// instance is the shader's gl_BaseInstance.
+void GeometryStore::DrawMesh(unsigned int a_handle,
+	unsigned int a_firstInstance,
+	unsigned int a_instanceCount) const
+{
+	const MeshRange& range = m_meshRanges[a_handle];
+	glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES,
+		(GLsizei)range.indexCount,
+		GL_UNSIGNED_INT,
+		((char*)0) + range.firstIndex * sizeof(unsigned int),
+		(GLsizei)a_instanceCount,
+		range.baseVertex,
+		a_firstInstance);
+}
+
+// Fills an indirect command that draws instances of a mesh.
+void GeometryStore::GetDrawCommand(unsigned int a_handle,
+	unsigned int a_firstInstance,
+	unsigned int a_instanceCount,
+	DrawCommand& a_command) const
+{
+	const MeshRange& range = m_meshRanges[a_handle];
+	a_command.indexCount = range.indexCount;
+	a_command.instanceCount = a_instanceCount;
+	a_command.firstIndex = range.firstIndex;
+	a_command.baseVertex = range.baseVertex;
+	a_command.baseInstance = a_firstInstance;
+}
+
+const GeometryStore::MeshRange& GeometryStore::GetMeshRange(unsigned int a_handle) const
+{
+	return m_meshRanges[a_handle];
+}
+
+unsigned int GeometryStore::GetVAO() const
+{
+	return m_uiVAO;
+}
+
+void GeometryStore::SetupVertexAttributes() const
+{
+	unsigned int index = 0;
+	const GLsizei uvComponents = 2;
+
+	if (m_bPackedVertices)
+	{
+		const GLsizei positionComponents = 3;
+		const GLsizei normalComponents = 4;
+		// Position, w is filled in as 1 by the vertex shader input.
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index,
+			positionComponents,
+			GL_FLOAT,
+			GL_FALSE,
+			m_uiVertexStride,
+			((char*)0) + OBJPackedVertex::OFFSETS_POSITION_OFFSET);
+		// Normal, signed 10:10:10:2 normalized back to -1 to 1.
+		glEnableVertexAttribArray(++index);
+		glVertexAttribPointer(index,
+			normalComponents,
+			GL_INT_2_10_10_10_REV,
+			GL_TRUE,
+			m_uiVertexStride,
+			((char*)0) + OBJPackedVertex::OFFSETS_NORMAL_OFFSET);
+		// UV Coordinates, half floats.
+		glEnableVertexAttribArray(++index);
+		glVertexAttribPointer(index,
+			uvComponents,
+			GL_HALF_FLOAT,
+			GL_FALSE,
+			m_uiVertexStride,
+			((char*)0) + OBJPackedVertex::OFFSETS_UV_COORDINATE_OFFSET);
+	}
+	else
+	{
+		const GLsizei vertexComponents = 4;
+		// Position.
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index,
+			vertexComponents,
+			GL_FLOAT,
+			GL_FALSE,
+			m_uiVertexStride,
+			((char*)0) + OBJVertex::OFFSETS_POSITION_OFFSET);
+		// Normal.
+		glEnableVertexAttribArray(++index);
+		glVertexAttribPointer(index,
+			vertexComponents,
+			GL_FLOAT,
+			GL_TRUE,
+			m_uiVertexStride,
+			((char*)0) + OBJVertex::OFFSETS_NORMAL_OFFSET);
+		// UV Coordinates.
+		glEnableVertexAttribArray(++index);
+		glVertexAttribPointer(index,
+			uvComponents,
+			GL_FLOAT,
+			GL_TRUE,
+			m_uiVertexStride,
+			((char*)0) + OBJVertex::OFFSETS_UV_COORDINATE_OFFSET);
+	}
+}
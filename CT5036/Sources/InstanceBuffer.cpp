@@ -0,0 +1,113 @@
+//////////////////////////////
+// File: InstanceBuffer.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "InstanceBuffer.h" // File's header.
+#include <algorithm>
+#include <cstring>
+#ifdef WIN64
+#include "GLAD/glad.h"
+#endif // WIN64.
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+#include "ShaderConstants.h"
+
+InstanceBuffer::InstanceBuffer() : m_uiBuffer(0),
+	m_uiCapacity(0),
+	m_uiDirtyBegin(0),
+	m_uiDirtyEnd(0),
+	m_transforms()
+{}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	const GLsizei toDelete = 1;
+	glDeleteBuffers(toDelete, &m_uiBuffer);
+}
+
+// Reserves consecutive transforms and returns the first one's index. New 
+// transforms start as identity matrices.
+unsigned int InstanceBuffer::Allocate(unsigned int a_count)
+{
+	unsigned int firstInstance = (unsigned int)m_transforms.size();
+	m_transforms.resize(m_transforms.size() + a_count, glm::mat4(1.0f));
+	// A clean buffer's range is empty, starting it at 0 would send every 
+	// transform again.
+	m_uiDirtyBegin = m_uiDirtyBegin >= m_uiDirtyEnd ? firstInstance : std::min(m_uiDirtyBegin, firstInstance);
+	m_uiDirtyEnd = (unsigned int)m_transforms.size();
+	return firstInstance;
+}
+
+void InstanceBuffer::SetTransform(unsigned int a_instance, const glm::mat4& a_transform)
+{
+	glm::mat4& transform = m_transforms[a_instance];
+
+	// Unchanged transforms don't need uploading again.
+	if (memcmp(&transform, &a_transform, sizeof(glm::mat4)) == 0)
+	{
+		return;
+	}
+
+	transform = a_transform;
+
+	if (m_uiDirtyBegin >= m_uiDirtyEnd)
+	{
+		m_uiDirtyBegin = a_instance;
+		m_uiDirtyEnd = a_instance + 1;
+	}
+	else
+	{
+		m_uiDirtyBegin = std::min(m_uiDirtyBegin, a_instance);
+		m_uiDirtyEnd = std::max(m_uiDirtyEnd, a_instance + 1);
+	}
+}
+
+const glm::mat4& InstanceBuffer::GetTransform(unsigned int a_instance) const
+{
+	return m_transforms[a_instance];
+}
+
+unsigned int InstanceBuffer::GetInstanceCount() const
+{
+	return (unsigned int)m_transforms.size();
+}
+
+// Sends the transforms changed since the last upload to the GPU.
+void InstanceBuffer::Upload()
+{
+	if (m_transforms.size() > m_uiCapacity)
+	{
+		// Immutable storage can't grow, so replace it and send everything.
+		const GLsizei buffers = 1;
+		glDeleteBuffers(buffers, &m_uiBuffer);
+		glGenBuffers(buffers, &m_uiBuffer);
+		m_uiCapacity = (unsigned int)m_transforms.size();
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiBuffer);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER,
+			m_uiCapacity * sizeof(glm::mat4),
+			m_transforms.data(),
+			GL_DYNAMIC_STORAGE_BIT);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		m_uiDirtyBegin = m_uiDirtyEnd = 0;
+		return;
+	}
+
+	if (m_uiDirtyBegin < m_uiDirtyEnd)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiBuffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+			m_uiDirtyBegin * sizeof(glm::mat4),
+			(m_uiDirtyEnd - m_uiDirtyBegin) * sizeof(glm::mat4),
+			&m_transforms[m_uiDirtyBegin]);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		m_uiDirtyBegin = m_uiDirtyEnd = 0;
+	}
+}
+
+void InstanceBuffer::Bind() const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ShaderConstants::BINDINGS_INSTANCES, m_uiBuffer);
+}
@@ -5,14 +5,26 @@
 //////////////////////////////
 
 #include "Renderer.h"
+#include <cstring>
 
 #ifdef WIN64
-int main()
+int main(int a_argumentCount, char* a_arguments[])
 #elif NX64
 extern "C" void nnMain()
 #endif // WIN64 / NX64.
 {
 	Renderer* pRenderer = new Renderer();
+#ifdef WIN64
+	// -benchmark adds the instancing benchmark's prop field to the scene.
+	for (int i = 1; i < a_argumentCount; ++i)
+	{
+		if (strcmp(a_arguments[i], "-benchmark") == 0)
+		{
+			pRenderer->SetPropField(true);
+		}
+	}
+#endif // WIN64.
+
 	const unsigned int windowWidth = 1920;
 	const unsigned int windowHeight = 1080;
 	pRenderer->Run("My Application", windowWidth, windowHeight, false);
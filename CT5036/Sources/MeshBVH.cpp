@@ -0,0 +1,449 @@
+//////////////////////////////
+// File: MeshBVH.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "MeshBVH.h" // File's header.
+#include <algorithm>
+#include <limits>
+#include "OBJLoader.h"
+#include "SceneBVH.h"
+#ifdef WIN64
+#include <xmmintrin.h>
+#endif // WIN64.
+
+const unsigned int MeshBVH::ms_uiEmptyChild = 0xFFFFFFFF;
+
+MeshBVH::MeshBVH() : m_uiTriangleCount(0),
+	m_nodes(),
+	m_cornerX(),
+	m_cornerY(),
+	m_cornerZ(),
+	m_edgeAX(),
+	m_edgeAY(),
+	m_edgeAZ(),
+	m_edgeBX(),
+	m_edgeBY(),
+	m_edgeBZ(),
+	m_triangles()
+{}
+
+MeshBVH::~MeshBVH()
+{}
+
+// Builds the hierarchy over the mesh's triangles in model space.
+void MeshBVH::Build(OBJMesh* a_pMesh)
+{
+	const std::vector<unsigned int>& indices = *a_pMesh->GetIndices();
+	std::vector<glm::vec3> positions;
+
+	if (a_pMesh->IsPacked())
+	{
+		const std::vector<OBJPackedVertex>& vertices = *a_pMesh->GetPackedVertices();
+		positions.reserve(vertices.size());
+
+		for (auto iterator = vertices.begin(); iterator != vertices.end(); ++iterator)
+		{
+			positions.push_back(iterator->GetPosition());
+		}
+	}
+	else
+	{
+		const std::vector<OBJVertex>& vertices = *a_pMesh->GetVertices();
+		positions.reserve(vertices.size());
+
+		for (auto iterator = vertices.begin(); iterator != vertices.end(); ++iterator)
+		{
+			positions.push_back(glm::vec3(iterator->GetPosition()));
+		}
+	}
+
+	m_uiTriangleCount = (unsigned int)(indices.size() / 3);
+	std::vector<SceneBVH::Box> boxes(m_uiTriangleCount);
+
+	for (unsigned int triangle = 0; triangle < m_uiTriangleCount; ++triangle)
+	{
+		const glm::vec3& a = positions[indices[triangle * 3]];
+		const glm::vec3& b = positions[indices[triangle * 3 + 1]];
+		const glm::vec3& c = positions[indices[triangle * 3 + 2]];
+		boxes[triangle].min = glm::min(a, glm::min(b, c));
+		boxes[triangle].max = glm::max(a, glm::max(b, c));
+	}
+
+	// The binary SAH tree decides the grouping, it's then collapsed into 
+	// four wide nodes.
+	SceneBVH binary;
+	binary.Build(boxes);
+	m_nodes.clear();
+	m_triangles.clear();
+	m_triangles.reserve(m_uiTriangleCount);
+
+	if (m_uiTriangleCount > 0)
+	{
+		m_nodes.push_back(Node());
+		Collapse(binary, 0, 0);
+	}
+
+	// Padding triangles are degenerate, so they can never be hit.
+	const size_t paddedCount = m_triangles.size() + 3;
+	m_cornerX.assign(paddedCount, 0.f);
+	m_cornerY.assign(paddedCount, 0.f);
+	m_cornerZ.assign(paddedCount, 0.f);
+	m_edgeAX.assign(paddedCount, 0.f);
+	m_edgeAY.assign(paddedCount, 0.f);
+	m_edgeAZ.assign(paddedCount, 0.f);
+	m_edgeBX.assign(paddedCount, 0.f);
+	m_edgeBY.assign(paddedCount, 0.f);
+	m_edgeBZ.assign(paddedCount, 0.f);
+
+	for (unsigned int i = 0; i < m_triangles.size(); ++i)
+	{
+		const unsigned int triangle = m_triangles[i];
+		const glm::vec3& a = positions[indices[triangle * 3]];
+		const glm::vec3 edgeA = positions[indices[triangle * 3 + 1]] - a;
+		const glm::vec3 edgeB = positions[indices[triangle * 3 + 2]] - a;
+		m_cornerX[i] = a.x;
+		m_cornerY[i] = a.y;
+		m_cornerZ[i] = a.z;
+		m_edgeAX[i] = edgeA.x;
+		m_edgeAY[i] = edgeA.y;
+		m_edgeAZ[i] = edgeA.z;
+		m_edgeBX[i] = edgeB.x;
+		m_edgeBY[i] = edgeB.y;
+		m_edgeBZ[i] = edgeB.z;
+	}
+}
+
+// Finds the closest triangle the ray hits within the maximum distance. 
+// Distances are measured in multiples of the direction's length.
+bool MeshBVH::Raycast(const glm::vec3& a_origin,
+	const glm::vec3& a_direction,
+	float a_maxDistance,
+	Hit& a_hit) const
+{
+	a_hit.distance = a_maxDistance;
+	a_hit.triangle = ms_uiEmptyChild;
+
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	typedef struct StackEntry
+	{
+		unsigned int index;
+		unsigned int count;
+		float distance;
+	} StackEntry;
+
+	// Each visit replaces one entry with at most four, so this covers 
+	// trees far deeper than any mesh produces.
+	const unsigned int maxStackSize = 256;
+	StackEntry stack[maxStackSize];
+	unsigned int stackSize = 0;
+	stack[stackSize].index = 0;
+	stack[stackSize].count = 0;
+	stack[stackSize].distance = 0.f;
+	++stackSize;
+	const glm::vec3 inverseDirection = 1.f / a_direction;
+
+	while (stackSize > 0)
+	{
+		const StackEntry entry = stack[--stackSize];
+
+		// Something closer was hit since this entry was pushed.
+		if (entry.distance > a_hit.distance)
+		{
+			continue;
+		}
+
+		if (entry.count > 0)
+		{
+			IntersectTriangles(entry.index, entry.count, a_origin, a_direction, a_hit);
+			continue;
+		}
+
+		const Node& node = m_nodes[entry.index];
+		float entryDistances[4];
+		int hitMask = 0;
+#ifdef WIN64
+		const __m128 originX = _mm_set1_ps(a_origin.x);
+		const __m128 originY = _mm_set1_ps(a_origin.y);
+		const __m128 originZ = _mm_set1_ps(a_origin.z);
+		const __m128 inverseX = _mm_set1_ps(inverseDirection.x);
+		const __m128 inverseY = _mm_set1_ps(inverseDirection.y);
+		const __m128 inverseZ = _mm_set1_ps(inverseDirection.z);
+		const __m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minX), originX), inverseX);
+		const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxX), originX), inverseX);
+		const __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minY), originY), inverseY);
+		const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxY), originY), inverseY);
+		const __m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minZ), originZ), inverseZ);
+		const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxZ), originZ), inverseZ);
+		__m128 entryTime = _mm_max_ps(_mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)),
+			_mm_max_ps(_mm_min_ps(z0, z1), _mm_setzero_ps()));
+		__m128 exitTime = _mm_min_ps(_mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)),
+			_mm_min_ps(_mm_max_ps(z0, z1), _mm_set1_ps(a_hit.distance)));
+		hitMask = _mm_movemask_ps(_mm_cmple_ps(entryTime, exitTime));
+		_mm_storeu_ps(entryDistances, entryTime);
+#else
+		for (unsigned int child = 0; child < 4; ++child)
+		{
+			const float x0 = (node.minX[child] - a_origin.x) * inverseDirection.x;
+			const float x1 = (node.maxX[child] - a_origin.x) * inverseDirection.x;
+			const float y0 = (node.minY[child] - a_origin.y) * inverseDirection.y;
+			const float y1 = (node.maxY[child] - a_origin.y) * inverseDirection.y;
+			const float z0 = (node.minZ[child] - a_origin.z) * inverseDirection.z;
+			const float z1 = (node.maxZ[child] - a_origin.z) * inverseDirection.z;
+			const float entryTime = std::max(std::max(std::min(x0, x1), std::min(y0, y1)),
+				std::max(std::min(z0, z1), 0.f));
+			const float exitTime = std::min(std::min(std::max(x0, x1), std::max(y0, y1)),
+				std::min(std::max(z0, z1), a_hit.distance));
+			entryDistances[child] = entryTime;
+			hitMask |= entryTime <= exitTime ? 1 << child : 0;
+		}
+#endif // WIN64.
+
+		// Push the furthest child first so the nearest is visited next.
+		unsigned int order[4];
+		unsigned int orderCount = 0;
+
+		for (unsigned int child = 0; child < 4; ++child)
+		{
+			if ((hitMask & (1 << child)) && node.children[child] != ms_uiEmptyChild)
+			{
+				unsigned int slot = orderCount++;
+
+				while (slot > 0 && entryDistances[order[slot - 1]] < entryDistances[child])
+				{
+					order[slot] = order[slot - 1];
+					--slot;
+				}
+
+				order[slot] = child;
+			}
+		}
+
+		for (unsigned int i = 0; i < orderCount && stackSize < maxStackSize; ++i)
+		{
+			stack[stackSize].index = node.children[order[i]];
+			stack[stackSize].count = node.counts[order[i]];
+			stack[stackSize].distance = entryDistances[order[i]];
+			++stackSize;
+		}
+	}
+
+	return a_hit.triangle != ms_uiEmptyChild;
+}
+
+unsigned int MeshBVH::GetTriangleCount() const
+{
+	return m_uiTriangleCount;
+}
+
+unsigned int MeshBVH::GetNodeCount() const
+{
+	return (unsigned int)m_nodes.size();
+}
+
+// Fills a node with up to four descendants of a binary node, opening the 
+// largest interior descendant until four are found.
+void MeshBVH::Collapse(const SceneBVH& a_binary, unsigned int a_binaryNode, unsigned int a_node)
+{
+	unsigned int descendants[4];
+	unsigned int descendantCount = 0;
+	const SceneBVH::Node& binaryNode = a_binary.GetNode(a_binaryNode);
+
+	if (binaryNode.count > 0)
+	{
+		// A leaf root still needs a node to hold it.
+		descendants[descendantCount++] = a_binaryNode;
+	}
+	else
+	{
+		descendants[descendantCount++] = binaryNode.first;
+		descendants[descendantCount++] = binaryNode.first + 1;
+	}
+
+	while (descendantCount < 4)
+	{
+		int largest = -1;
+		float largestArea = -1.f;
+
+		for (unsigned int i = 0; i < descendantCount; ++i)
+		{
+			const SceneBVH::Node& descendant = a_binary.GetNode(descendants[i]);
+
+			if (descendant.count > 0)
+			{
+				continue;
+			}
+
+			const glm::vec3 size = descendant.max - descendant.min;
+			const float area = size.x * size.y + size.y * size.z + size.z * size.x;
+
+			if (area > largestArea)
+			{
+				largestArea = area;
+				largest = (int)i;
+			}
+		}
+
+		if (largest < 0)
+		{
+			break;
+		}
+
+		const unsigned int firstChild = a_binary.GetNode(descendants[largest]).first;
+		descendants[largest] = firstChild;
+		descendants[descendantCount++] = firstChild + 1;
+	}
+
+	for (unsigned int child = 0; child < 4; ++child)
+	{
+		// Empty slots get inside out bounds so rays always miss them.
+		if (child >= descendantCount)
+		{
+			Node& node = m_nodes[a_node];
+			node.minX[child] = node.minY[child] = node.minZ[child] = std::numeric_limits<float>::max();
+			node.maxX[child] = node.maxY[child] = node.maxZ[child] = -std::numeric_limits<float>::max();
+			node.children[child] = ms_uiEmptyChild;
+			node.counts[child] = 0;
+			continue;
+		}
+
+		const SceneBVH::Node& descendant = a_binary.GetNode(descendants[child]);
+		unsigned int childIndex = 0;
+
+		if (descendant.count > 0)
+		{
+			childIndex = (unsigned int)m_triangles.size();
+
+			for (unsigned int i = descendant.first; i < descendant.first + descendant.count; ++i)
+			{
+				m_triangles.push_back(a_binary.GetItem(i));
+			}
+		}
+		else
+		{
+			childIndex = (unsigned int)m_nodes.size();
+			m_nodes.push_back(Node());
+			Collapse(a_binary, descendants[child], childIndex);
+		}
+
+		// Collapsing can grow the node list, so look the node up again.
+		Node& node = m_nodes[a_node];
+		node.minX[child] = descendant.min.x;
+		node.minY[child] = descendant.min.y;
+		node.minZ[child] = descendant.min.z;
+		node.maxX[child] = descendant.max.x;
+		node.maxY[child] = descendant.max.y;
+		node.maxZ[child] = descendant.max.z;
+		node.children[child] = childIndex;
+		node.counts[child] = descendant.count;
+	}
+}
+
+// Tests a leaf's triangles four at a time and updates the hit when one is 
+// closer.
+void MeshBVH::IntersectTriangles(unsigned int a_first,
+	unsigned int a_count,
+	const glm::vec3& a_origin,
+	const glm::vec3& a_direction,
+	Hit& a_hit) const
+{
+	// Möller-Trumbore, without culling back faces.
+	const float parallelEpsilon = 1e-12f;
+
+	for (unsigned int batch = a_first; batch < a_first + a_count; batch += 4)
+	{
+		const unsigned int lanes = std::min(4u, a_first + a_count - batch);
+		float distances[4];
+		float us[4];
+		float vs[4];
+		int hitMask = 0;
+#ifdef WIN64
+		const __m128 directionX = _mm_set1_ps(a_direction.x);
+		const __m128 directionY = _mm_set1_ps(a_direction.y);
+		const __m128 directionZ = _mm_set1_ps(a_direction.z);
+		const __m128 edgeAX = _mm_loadu_ps(&m_edgeAX[batch]);
+		const __m128 edgeAY = _mm_loadu_ps(&m_edgeAY[batch]);
+		const __m128 edgeAZ = _mm_loadu_ps(&m_edgeAZ[batch]);
+		const __m128 edgeBX = _mm_loadu_ps(&m_edgeBX[batch]);
+		const __m128 edgeBY = _mm_loadu_ps(&m_edgeBY[batch]);
+		const __m128 edgeBZ = _mm_loadu_ps(&m_edgeBZ[batch]);
+		// p = direction x edgeB.
+		const __m128 pX = _mm_sub_ps(_mm_mul_ps(directionY, edgeBZ), _mm_mul_ps(directionZ, edgeBY));
+		const __m128 pY = _mm_sub_ps(_mm_mul_ps(directionZ, edgeBX), _mm_mul_ps(directionX, edgeBZ));
+		const __m128 pZ = _mm_sub_ps(_mm_mul_ps(directionX, edgeBY), _mm_mul_ps(directionY, edgeBX));
+		const __m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeAX, pX), _mm_mul_ps(edgeAY, pY)),
+			_mm_mul_ps(edgeAZ, pZ));
+		// |determinant| > epsilon, the sign bit is cleared for the absolute.
+		const __m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 hit = _mm_cmpgt_ps(_mm_and_ps(determinant, absoluteMask), _mm_set1_ps(parallelEpsilon));
+		const __m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.f), determinant);
+		// t = origin - corner.
+		const __m128 tX = _mm_sub_ps(_mm_set1_ps(a_origin.x), _mm_loadu_ps(&m_cornerX[batch]));
+		const __m128 tY = _mm_sub_ps(_mm_set1_ps(a_origin.y), _mm_loadu_ps(&m_cornerY[batch]));
+		const __m128 tZ = _mm_sub_ps(_mm_set1_ps(a_origin.z), _mm_loadu_ps(&m_cornerZ[batch]));
+		const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tX, pX), _mm_mul_ps(tY, pY)),
+			_mm_mul_ps(tZ, pZ)), inverseDeterminant);
+		// q = t x edgeA.
+		const __m128 qX = _mm_sub_ps(_mm_mul_ps(tY, edgeAZ), _mm_mul_ps(tZ, edgeAY));
+		const __m128 qY = _mm_sub_ps(_mm_mul_ps(tZ, edgeAX), _mm_mul_ps(tX, edgeAZ));
+		const __m128 qZ = _mm_sub_ps(_mm_mul_ps(tX, edgeAY), _mm_mul_ps(tY, edgeAX));
+		const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, qX), _mm_mul_ps(directionY, qY)),
+			_mm_mul_ps(directionZ, qZ)), inverseDeterminant);
+		const __m128 distance = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeBX, qX), _mm_mul_ps(edgeBY, qY)),
+			_mm_mul_ps(edgeBZ, qZ)), inverseDeterminant);
+		const __m128 zero = _mm_setzero_ps();
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+		hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.f)));
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(distance, zero));
+		hit = _mm_and_ps(hit, _mm_cmplt_ps(distance, _mm_set1_ps(a_hit.distance)));
+		hitMask = _mm_movemask_ps(hit);
+		_mm_storeu_ps(distances, distance);
+		_mm_storeu_ps(us, u);
+		_mm_storeu_ps(vs, v);
+#else
+		for (unsigned int lane = 0; lane < 4; ++lane)
+		{
+			const unsigned int i = batch + lane;
+			const glm::vec3 edgeA(m_edgeAX[i], m_edgeAY[i], m_edgeAZ[i]);
+			const glm::vec3 edgeB(m_edgeBX[i], m_edgeBY[i], m_edgeBZ[i]);
+			const glm::vec3 p = glm::cross(a_direction, edgeB);
+			const float determinant = glm::dot(edgeA, p);
+
+			if (std::abs(determinant) <= parallelEpsilon)
+			{
+				continue;
+			}
+
+			const float inverseDeterminant = 1.f / determinant;
+			const glm::vec3 t = a_origin - glm::vec3(m_cornerX[i], m_cornerY[i], m_cornerZ[i]);
+			const glm::vec3 q = glm::cross(t, edgeA);
+			us[lane] = glm::dot(t, p) * inverseDeterminant;
+			vs[lane] = glm::dot(a_direction, q) * inverseDeterminant;
+			distances[lane] = glm::dot(edgeB, q) * inverseDeterminant;
+
+			if (us[lane] >= 0.f && vs[lane] >= 0.f && us[lane] + vs[lane] <= 1.f &&
+				distances[lane] >= 0.f && distances[lane] < a_hit.distance)
+			{
+				hitMask |= 1 << lane;
+			}
+		}
+#endif // WIN64.
+
+		for (unsigned int lane = 0; lane < lanes; ++lane)
+		{
+			if ((hitMask & (1 << lane)) && distances[lane] < a_hit.distance)
+			{
+				a_hit.distance = distances[lane];
+				a_hit.triangle = m_triangles[batch + lane];
+				a_hit.u = us[lane];
+				a_hit.v = vs[lane];
+			}
+		}
+	}
+}
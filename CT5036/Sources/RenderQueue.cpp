@@ -0,0 +1,292 @@
+//////////////////////////////
+// File: RenderQueue.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "RenderQueue.h" // File's header.
+#include <algorithm>
+#ifdef WIN64
+#include "GLAD/glad.h"
+#endif // WIN64.
+#ifdef NX64
+#include <nn/gll.h>
+#endif // NX64.
+#include "ShaderConstants.h"
+#include "ShaderUtilities.h"
+#include "TextureManager.h"
+
+const unsigned int RenderQueue::ms_uiUnusedTexture = 0xFFFFFFFF;
+
+RenderQueue::RenderQueue() : m_bMultiDraw(true),
+	m_uiCommandBuffer(0),
+	m_uiDrawDataBuffer(0),
+	m_uiDrawCapacity(0),
+	m_items(),
+	m_sortEntries(),
+	m_drawCommands(),
+	m_drawMaterials(),
+	m_frameStatistics(),
+	m_totalStatistics()
+{}
+
+RenderQueue::~RenderQueue()
+{
+	const GLsizei toDelete = 1;
+	glDeleteBuffers(toDelete, &m_uiCommandBuffer);
+	glDeleteBuffers(toDelete, &m_uiDrawDataBuffer);
+}
+
+void RenderQueue::Submit(const DrawItem& a_item)
+{
+	m_items.push_back(a_item);
+}
+
+// Sorts the submitted items, draws them and empties the queue. The geometry 
+// store's VAO must be bound.
+void RenderQueue::Execute(const GeometryStore* a_pGeometryStore)
+{
+	m_frameStatistics = Statistics();
+	m_sortEntries.resize(m_items.size());
+	TextureManager* pTextureManager = TextureManager::GetInstance();
+	// Bindless draws read their textures through the material table, so 
+	// they're no reason to sort or split runs.
+	const bool bBindless = pTextureManager->IsBindless();
+
+	for (unsigned int i = 0; i < m_items.size(); ++i)
+	{
+		m_sortEntries[i].key = MakeSortKey(m_items[i], !bBindless);
+		m_sortEntries[i].item = i;
+	}
+
+	std::sort(m_sortEntries.begin(), m_sortEntries.end());
+	m_drawCommands.resize(m_sortEntries.size());
+	m_drawMaterials.resize(m_sortEntries.size());
+
+	// Commands are built in sorted order so each run of shared state is a 
+	// contiguous range of the command buffer.
+	for (unsigned int i = 0; i < m_sortEntries.size(); ++i)
+	{
+		const DrawItem& item = m_items[m_sortEntries[i].item];
+		a_pGeometryStore->GetDrawCommand(item.geometryHandle,
+			item.firstInstance,
+			item.instanceCount,
+			m_drawCommands[i]);
+		m_drawMaterials[i] = item.materialIndex;
+		++m_frameStatistics.draws;
+		m_frameStatistics.instances += item.instanceCount;
+	}
+
+	UploadDrawData();
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ShaderConstants::BINDINGS_DRAWS, m_uiDrawDataBuffer);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_uiCommandBuffer);
+	// State is unknown at the start of the queue, so the first item always 
+	// sets everything.
+	bool bFirstItem = true;
+	unsigned int currentProgram = 0;
+	unsigned int currentTextures[TEXTURE_UNITS_COUNT];
+	int drawOffsetLocation = -1;
+	// First command of the run waiting to be multi-drawn.
+	unsigned int runStart = 0;
+
+	for (unsigned int i = 0; i < TEXTURE_UNITS_COUNT; ++i)
+	{
+		currentTextures[i] = ms_uiUnusedTexture;
+	}
+
+	for (unsigned int i = 0; i < m_sortEntries.size(); ++i)
+	{
+		const DrawItem& item = m_items[m_sortEntries[i].item];
+		bool bStateChange = bFirstItem || item.program != currentProgram;
+
+		for (unsigned int unit = 0; unit < TEXTURE_UNITS_COUNT && !bBindless; ++unit)
+		{
+			if (item.textures[unit] != ms_uiUnusedTexture && item.textures[unit] != currentTextures[unit])
+			{
+				bStateChange = true;
+			}
+		}
+
+		// The run so far must be drawn before its state is replaced.
+		if (m_bMultiDraw && bStateChange && i > runStart)
+		{
+			SubmitMultiDraw(runStart, i - runStart, drawOffsetLocation);
+			runStart = i;
+		}
+
+		if (bFirstItem || item.program != currentProgram)
+		{
+			glUseProgram(item.program);
+			currentProgram = item.program;
+			drawOffsetLocation = ShaderUtilities::GetUniformLocation(currentProgram,
+				ShaderUtilities::UNIFORMS_DRAW_OFFSET);
+			const int bindlessLocation = ShaderUtilities::GetUniformLocation(currentProgram,
+				ShaderUtilities::UNIFORMS_BINDLESS_TEXTURES);
+			glUniform1i(bindlessLocation, bBindless ? GL_TRUE : GL_FALSE);
+			++m_frameStatistics.programBinds;
+		}
+		else
+		{
+			++m_frameStatistics.programBindsAvoided;
+		}
+
+		for (unsigned int unit = 0; unit < TEXTURE_UNITS_COUNT; ++unit)
+		{
+			if (item.textures[unit] == ms_uiUnusedTexture)
+			{
+				continue;
+			}
+
+			// Every draw asks for the mips it needs, even when its textures 
+			// are already bound.
+			pTextureManager->RequestTexture(item.textures[unit], item.texelsPerUV);
+
+			if (bBindless)
+			{
+				++m_frameStatistics.textureBindsAvoided;
+			}
+			else if (item.textures[unit] != currentTextures[unit])
+			{
+				glActiveTexture(GL_TEXTURE0 + unit);
+				glBindTexture(GL_TEXTURE_2D, pTextureManager->GetTextureName(item.textures[unit]));
+				currentTextures[unit] = item.textures[unit];
+				++m_frameStatistics.textureBinds;
+			}
+			else
+			{
+				++m_frameStatistics.textureBindsAvoided;
+			}
+		}
+
+		if (!m_bMultiDraw)
+		{
+			// gl_DrawID is 0 for single draws, so the offset selects the 
+			// draw's material.
+			glUniform1ui(drawOffsetLocation, i);
+			a_pGeometryStore->DrawMesh(item.geometryHandle, item.firstInstance, item.instanceCount);
+			++m_frameStatistics.drawCalls;
+		}
+
+		bFirstItem = false;
+	}
+
+	if (m_bMultiDraw && m_sortEntries.size() > runStart)
+	{
+		SubmitMultiDraw(runStart, (unsigned int)m_sortEntries.size() - runStart, drawOffsetLocation);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	m_items.clear();
+	AddStatistics(m_totalStatistics, m_frameStatistics);
+}
+
+// Submits runs of draws sharing state with one multi-draw call, otherwise 
+// every draw is its own call.
+void RenderQueue::SetMultiDraw(bool a_multiDraw)
+{
+	m_bMultiDraw = a_multiDraw;
+}
+
+bool RenderQueue::IsMultiDraw() const
+{
+	return m_bMultiDraw;
+}
+
+// Counters for the last Execute call.
+const RenderQueue::Statistics& RenderQueue::GetFrameStatistics() const
+{
+	return m_frameStatistics;
+}
+
+// Counters summed over every Execute call.
+const RenderQueue::Statistics& RenderQueue::GetTotalStatistics() const
+{
+	return m_totalStatistics;
+}
+
+// Packs the state that's most expensive to change into the highest bits so 
+// sorting groups it together. From the top: program, diffuse texture, 
+// material and mesh, 16 bits each. The texture is left out when textures 
+// aren't bound.
+unsigned long long RenderQueue::MakeSortKey(const DrawItem& a_item, bool a_bTextures)
+{
+	const unsigned long long fieldMask = 0xFFFF;
+	unsigned long long key = (a_item.program & fieldMask) << 48;
+	key |= a_bTextures ? (a_item.textures[TEXTURE_UNITS_DIFFUSE] & fieldMask) << 32 : 0;
+	key |= (a_item.materialIndex & fieldMask) << 16;
+	key |= a_item.geometryHandle & fieldMask;
+	return key;
+}
+
+void RenderQueue::AddStatistics(Statistics& a_total, const Statistics& a_frame)
+{
+	a_total.draws += a_frame.draws;
+	a_total.instances += a_frame.instances;
+	a_total.drawCalls += a_frame.drawCalls;
+	a_total.programBinds += a_frame.programBinds;
+	a_total.programBindsAvoided += a_frame.programBindsAvoided;
+	a_total.textureBinds += a_frame.textureBinds;
+	a_total.textureBindsAvoided += a_frame.textureBindsAvoided;
+}
+
+// Copies this frame's commands and per draw data to the GPU, growing the 
+// buffers when needed.
+void RenderQueue::UploadDrawData()
+{
+	const unsigned int drawCount = (unsigned int)m_drawCommands.size();
+
+	if (drawCount == 0)
+	{
+		return;
+	}
+
+	if (drawCount > m_uiDrawCapacity)
+	{
+		// Immutable storage can't grow, so replace it with room to spare for 
+		// frames that draw a little more.
+		const GLsizei buffers = 1;
+		glDeleteBuffers(buffers, &m_uiCommandBuffer);
+		glDeleteBuffers(buffers, &m_uiDrawDataBuffer);
+		glGenBuffers(buffers, &m_uiCommandBuffer);
+		glGenBuffers(buffers, &m_uiDrawDataBuffer);
+		m_uiDrawCapacity = std::max(drawCount, m_uiDrawCapacity * 2);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_uiCommandBuffer);
+		glBufferStorage(GL_DRAW_INDIRECT_BUFFER,
+			m_uiDrawCapacity * sizeof(GeometryStore::DrawCommand),
+			nullptr,
+			GL_DYNAMIC_STORAGE_BIT);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiDrawDataBuffer);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER,
+			m_uiDrawCapacity * sizeof(unsigned int),
+			nullptr,
+			GL_DYNAMIC_STORAGE_BIT);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_uiCommandBuffer);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER,
+		0,
+		drawCount * sizeof(GeometryStore::DrawCommand),
+		m_drawCommands.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiDrawDataBuffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+		0,
+		drawCount * sizeof(unsigned int),
+		m_drawMaterials.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+// Draws the commands in [a_first, a_first + a_count) with one call.
+void RenderQueue::SubmitMultiDraw(unsigned int a_first,
+	unsigned int a_count,
+	int a_drawOffsetLocation)
+{
+	const GLsizei tightlyPacked = 0;
+	glUniform1ui(a_drawOffsetLocation, a_first);
+	glMultiDrawElementsIndirect(GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		((char*)0) + a_first * sizeof(GeometryStore::DrawCommand),
+		(GLsizei)a_count,
+		tightlyPacked);
+	++m_frameStatistics.drawCalls;
+}
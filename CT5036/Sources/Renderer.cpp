@@ -6,13 +6,26 @@
 
 #include "Renderer.h" // File's header.
 #include "DebugCamera.h"
+#include "GeometryStore.h"
+#include "FrustumCuller.h"
 #include "GLM/ext.hpp"
+#include "InstanceBuffer.h"
 #include <iostream>
 #include "OBJLoader.h"
+#include "SceneBVH.h"
+#include "SceneGraph.h"
+#include "ScenePicker.h"
+#include "ShaderConstants.h"
 #include "ShaderUtilities.h"
 #include "Skybox.h"
+#include "TextureAtlas.h"
 #include "TextureManager.h"
 #include "Utilities.h"
+#include <chrono>
+#include <unordered_map>
+#ifdef WIN64
+#include "GLFW/glfw3.h"
+#endif // WIN64.
 
 #ifdef NX64
 #include <nn/fs.h>
@@ -26,11 +39,31 @@ Renderer::Renderer() : m_uiProgram(0),
 	m_uiOBJProgram(0),
 	m_uiSkyboxProgram(0),
 	m_uiCurrentProgram(0),
-	m_uiOBJModelVAO(0),
 	m_uiNumberOfModels(0),
-	m_uiOBJModelBuffer(),
+	m_bPackOBJVertices(true),
+	m_bPackTextureAtlases(true),
+	m_bPropField(false),
+	m_bInstanceProps(true),
+	m_dDrawSeconds(0.0),
+	m_uiDrawFrames(0),
 	m_poDebugCamera(nullptr),
+	m_poGeometryStore(nullptr),
+	m_poShaderConstants(nullptr),
 	m_poOBJModels(),
+	m_objMeshDraws(),
+	m_uiOBJModelNodes(),
+	m_poInstanceBuffer(nullptr),
+	m_poFrustumCuller(nullptr),
+	m_poSceneGraph(nullptr),
+	m_poScenePicker(nullptr),
+	m_uiPropFieldNode(0),
+	m_bSpinProps(false),
+	m_fPropFieldAngle(0.f),
+	m_propFieldCentre(0.f, 0.f, -75.f),
+	m_uiNodesUpdated(0),
+	m_poPropModels(),
+	m_propMeshDraws(),
+	m_poRenderQueue(nullptr),
 	m_pLines(nullptr),
 	m_poSkybox(nullptr)
 {
@@ -79,6 +112,134 @@ DebugCamera* Renderer::GetCamera() const
 	return m_poDebugCamera;
 }
 
+// Adds the 10,000 prop benchmark field to the scene, must be set before Run.
+void Renderer::SetPropField(bool a_bPropField)
+{
+	m_bPropField = a_bPropField;
+}
+
+// Loads a model, registers its materials and textures and reserves its 
+// meshes in the geometry store. Each mesh's draw is added to the list 
+// without an instance range.
+bool Renderer::LoadOBJModel(OBJModel* a_pModel,
+	unsigned int a_defaultMaterialIndex,
+	std::vector<RenderQueue::DrawItem>& a_meshDraws)
+{
+	a_pModel->SetVertexFormat(m_bPackOBJVertices ?
+		OBJModel::VERTEX_FORMATS_PACKED :
+		OBJModel::VERTEX_FORMATS_FULL);
+
+	// Load replaces the file path with the model's directory, atlases are 
+	// named after the model's file.
+	const std::string modelFilename = a_pModel->GetFilePath();
+
+	if (!a_pModel->Load(modelFilename.c_str()))
+	{
+		std::cout << "Failed to Load Model.\n";
+		return false;
+	}
+
+	TextureManager* pTextureManager = TextureManager::GetInstance();
+	std::unordered_map<const OBJMaterial*, unsigned int> materialIndices;
+
+	// Atlases must be packed before their textures are loaded.
+	for (int j = 0; j < OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_COUNT && m_bPackTextureAtlases; ++j)
+	{
+		const OBJMaterial::TEXTURE_TYPES type = (OBJMaterial::TEXTURE_TYPES)j;
+		std::vector<std::string> textures;
+		TextureAtlas::GetModelTextures(a_pModel, type, textures);
+		pTextureManager->PackAtlas(TextureAtlas::GetAtlasFileName(modelFilename.c_str(), type).c_str(), textures);
+	}
+
+	// Load in the model's textures.
+	for (unsigned int i = 0; i < a_pModel->GetMaterialCount(); ++i)
+	{
+		OBJMaterial* material = a_pModel->GetMaterialByIndex(i);
+		glm::vec4 uvTransforms[OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_COUNT];
+
+		for (int j = 0; j < OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_COUNT; ++j)
+		{
+			uvTransforms[j] = glm::vec4(1.f, 1.f, 0.f, 0.f);
+
+			if (material->GetTextureFileName(j).size() > 0)
+			{
+				// Materials keep the manager's handle, resolved to a GL name 
+				// as the render queue binds it.
+				unsigned int texture = pTextureManager->LoadTexture(material->GetTextureFileName(j).c_str(),
+					j == OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_NORMAL,
+					&uvTransforms[j]);
+				material->SetTextureID(j, texture);
+			}
+		}
+
+		// Bindless draws sample the textures the material table names.
+		const glm::uvec4 textures(material->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_DIFFUSE),
+			material->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_SPECULAR),
+			material->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_NORMAL),
+			0);
+		materialIndices[material] = m_poShaderConstants->AddMaterial(*material->GetKA(),
+			*material->GetKD(),
+			*material->GetKS(),
+			textures,
+			uvTransforms);
+	}
+
+	// Reserve the model's meshes in the shared geometry buffers.
+	for (unsigned int i = 0; i < a_pModel->GetMeshCount(); ++i)
+	{
+		OBJMesh* pMesh = a_pModel->GetMeshByIndex(i);
+		OBJMaterial* pMaterial = pMesh->GetMaterial();
+		RenderQueue::DrawItem meshDraw;
+		meshDraw.program = m_uiOBJProgram;
+		meshDraw.firstInstance = 0;
+		meshDraw.instanceCount = 0;
+		meshDraw.texelsPerUV = 0.f;
+
+		if (!m_poGeometryStore->AddMesh(pMesh, meshDraw.geometryHandle))
+		{
+			return false;
+		}
+
+		auto materialIterator = materialIndices.find(pMaterial);
+		meshDraw.materialIndex = materialIterator != materialIndices.end() ?
+			materialIterator->second :
+			a_defaultMaterialIndex;
+
+		// Meshes without a material leave whatever textures are bound.
+		for (unsigned int unit = 0; unit < RenderQueue::TEXTURE_UNITS_COUNT; ++unit)
+		{
+			meshDraw.textures[unit] = RenderQueue::ms_uiUnusedTexture;
+		}
+
+		if (pMaterial)
+		{
+			meshDraw.textures[RenderQueue::TEXTURE_UNITS_DIFFUSE] =
+				pMaterial->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_DIFFUSE);
+			meshDraw.textures[RenderQueue::TEXTURE_UNITS_SPECULAR] =
+				pMaterial->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_SPECULAR);
+			meshDraw.textures[RenderQueue::TEXTURE_UNITS_NORMAL] =
+				pMaterial->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_NORMAL);
+		}
+
+		a_meshDraws.push_back(meshDraw);
+		m_poScenePicker->AddMesh(meshDraw.geometryHandle, pMesh, a_pModel, i);
+	}
+
+	return true;
+}
+
+// Gives every draw in the list the same instance range.
+void Renderer::SetInstances(std::vector<RenderQueue::DrawItem>& a_meshDraws,
+	unsigned int a_firstInstance,
+	unsigned int a_instanceCount)
+{
+	for (auto iterator = a_meshDraws.begin(); iterator != a_meshDraws.end(); ++iterator)
+	{
+		iterator->firstInstance = a_firstInstance;
+		iterator->instanceCount = a_instanceCount;
+	}
+}
+
 
 bool Renderer::OnCreate()
 {
@@ -166,6 +327,16 @@ bool Renderer::OnCreate()
 		2.0f);
 	m_poOBJModels[1] = new OBJModel("Resources/obj_models/C1102056/C1102056.obj",
 		0.15f);
+
+	if (m_bPropField)
+	{
+		m_poPropModels[PROPS_CRATE] = new OBJModel("Resources/obj_models/Crate.obj",
+			0.25f);
+		m_poPropModels[PROPS_BARREL] = new OBJModel("Resources/obj_models/Wooden Barrel.obj",
+			0.015f);
+		m_poPropModels[PROPS_CHEST] = new OBJModel("Resources/obj_models/chest.obj",
+			0.15f);
+	}
 #elif N64
 	m_poOBJModels[0] = new OBJModel("rom:/obj_models/Brass Lion Knocker/golden-lion-knocker-edit.obj",
 		2.0f);
@@ -173,88 +344,133 @@ bool Renderer::OnCreate()
 		0.15f);
 #endif // WIN64 / N64.
 	m_poSkybox = new Skybox(this);
-
-	for (unsigned int model = 0; model < m_uiNumberOfModels; ++model) {
+	m_poGeometryStore = new GeometryStore(m_bPackOBJVertices);
+	m_poShaderConstants = new ShaderConstants();
+	m_poInstanceBuffer = new InstanceBuffer();
+	m_poFrustumCuller = new FrustumCuller(m_poGeometryStore, m_poInstanceBuffer);
+	m_poSceneGraph = new SceneGraph();
+	m_poScenePicker = new ScenePicker(m_poFrustumCuller, m_poInstanceBuffer);
+	m_poRenderQueue = new RenderQueue();
+	// Material 0 is used by meshes without a material.
+	const unsigned int defaultMaterialIndex = m_poShaderConstants->AddMaterial(glm::vec4(0.25f, 0.25f, 0.25f, 1.f),
+		glm::vec4(1.f, 1.f, 1.f, 1.f),
+		glm::vec4(1.f, 1.f, 1.f, 64.f));
+
+	// Setup shaders for OBJ model rendering.
+	// Create OBJ shader program.
 #ifdef WIN64
-		if (m_poOBJModels[model]->Load(m_poOBJModels[model]->GetFilePath()))
+	unsigned int objVertexShader = ShaderUtilities::LoadShader("Resources/Shaders/obj_vertex.glsl", GL_VERTEX_SHADER);
+	unsigned int objFragmentShader = ShaderUtilities::LoadShader("Resources/Shaders/obj_fragment.glsl", GL_FRAGMENT_SHADER);
 #elif NX64
-		// Slightly changed file path from win64 variant.
-		if (m_poOBJModels[model]->Load(m_poOBJModels[model]->GetFilePath()))
+	unsigned int objVertexShader = ShaderUtilities::LoadShader("rom:/Shaders/obj_vertex.glsl", GL_VERTEX_SHADER);
+	unsigned int objFragmentShader = ShaderUtilities::LoadShader("rom:/Shaders/obj_fragment.glsl", GL_FRAGMENT_SHADER);
 #endif // WIN64 / NX64.
+
+	m_uiOBJProgram = ShaderUtilities::CreateProgram(objVertexShader, objFragmentShader);
+	// Samplers always read the same texture units, so only set them once.
+	SetProgram(m_uiOBJProgram);
+	glUniform1i(ShaderUtilities::GetUniformLocation(m_uiOBJProgram, ShaderUtilities::UNIFORMS_DIFFUSE_TEXTURE), 0);
+	glUniform1i(ShaderUtilities::GetUniformLocation(m_uiOBJProgram, ShaderUtilities::UNIFORMS_SPECULAR_TEXTURE), 1);
+	glUniform1i(ShaderUtilities::GetUniformLocation(m_uiOBJProgram, ShaderUtilities::UNIFORMS_NORMAL_TEXTURE), 2);
+	SetProgram(0);
+
+	for (unsigned int model = 0; model < m_uiNumberOfModels; ++model)
+	{
+		if (!LoadOBJModel(m_poOBJModels[model], defaultMaterialIndex, m_objMeshDraws[model]))
 		{
-			TextureManager* pTextureManager = TextureManager::GetInstance();
+			return false;
+		}
 
-			// Load in the model's textures.
-			for (unsigned int i = 0; i < m_poOBJModels[model]->GetMaterialCount(); ++i)
+		// Each model is drawn once, from its own root node.
+		const unsigned int instance = m_poInstanceBuffer->Allocate(1);
+		SetInstances(m_objMeshDraws[model], instance, 1);
+		m_uiOBJModelNodes[model] = m_poSceneGraph->CreateNode(SceneGraph::ms_uiNoParent,
+			glm::mat4(1.f),
+			instance);
+	}
+
+	// Benchmark field of repeated props, each prop's instances are 
+	// allocated consecutively so one draw per mesh can cover all of them.
+	if (m_bPropField)
+	{
+		unsigned int propFirstInstances[PROPS_COUNT];
+		unsigned int propInstanceCounts[PROPS_COUNT];
+		const unsigned int propRows = 100;
+		const unsigned int propColumns = 100;
+
+		for (unsigned int prop = 0; prop < PROPS_COUNT; ++prop)
+		{
+			if (!LoadOBJModel(m_poPropModels[prop], defaultMaterialIndex, m_propMeshDraws[prop]))
 			{
-				OBJMaterial* material = m_poOBJModels[model]->GetMaterialByIndex(i);
+				return false;
+			}
+
+			// Props alternate along each row and column.
+			propInstanceCounts[prop] = 0;
 
-				for (int j = 0; j < OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_COUNT; ++j)
+			for (unsigned int cell = 0; cell < propRows * propColumns; ++cell)
+			{
+				if ((cell / propColumns + cell % propColumns) % PROPS_COUNT == prop)
 				{
-					if (material->GetTextureFileName(j).size() > 0)
-					{
-						unsigned int textureID = pTextureManager->LoadTexture(material->GetTextureFileName(j).c_str());
-						material->SetTextureID(j, textureID);
-					}
+					++propInstanceCounts[prop];
 				}
 			}
 
-			// Setup shaders for OBJ model rendering.
-			// Create OBJ shader program.
-#ifdef WIN64
-			unsigned int objVertexShader = ShaderUtilities::LoadShader("Resources/Shaders/obj_vertex.glsl", GL_VERTEX_SHADER);
-			unsigned int objFragmentShader = ShaderUtilities::LoadShader("Resources/Shaders/obj_fragment.glsl", GL_FRAGMENT_SHADER);
-#elif NX64
-			unsigned int objVertexShader = ShaderUtilities::LoadShader("rom:/Shaders/obj_vertex.glsl", GL_VERTEX_SHADER);
-			unsigned int objFragmentShader = ShaderUtilities::LoadShader("rom:/Shaders/obj_fragment.glsl", GL_FRAGMENT_SHADER);
-#endif // WIN64 / NX64.
-
-			m_uiOBJProgram = ShaderUtilities::CreateProgram(objVertexShader, objFragmentShader);
-			const GLsizei buffersToGenerate = 2;
-			// Set up vertex and index buffer for OBJ rendering.
-			glGenBuffers(buffersToGenerate, m_uiOBJModelBuffer);
-			// Set up vertex buffer data.
-			glBindBuffer(GL_ARRAY_BUFFER, m_uiOBJModelBuffer[0]);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiOBJModelBuffer[1]);
-			// Reset index to zero.
-			index = 0;
-			// Position.
-			glEnableVertexAttribArray(index);
-			glVertexAttribPointer(index,
-				vertexComponents,
-				GL_FLOAT,
-				GL_FALSE,
-				sizeof(OBJVertex),
-				((char*)0) + OBJVertex::OFFSETS_POSITION_OFFSET);
-			// Normal.
-			glEnableVertexAttribArray(++index);
-			glVertexAttribPointer(index,
-				vertexComponents,
-				GL_FLOAT,
-				GL_TRUE,
-				sizeof(OBJVertex),
-				((char*)0) + OBJVertex::OFFSETS_NORMAL_OFFSET);
-			// UV Coordinates.
-			glEnableVertexAttribArray(++index);
-			const GLsizei vertexComponents = 4;
-			const GLsizei uvComponents = 2;
-			glVertexAttribPointer(index,
-				uvComponents,
-				GL_FLOAT,
-				GL_TRUE,
-				sizeof(OBJVertex),
-				((char*)0) + OBJVertex::OFFSETS_UV_COORDINATE_OFFSET);
-			glBindVertexArray(0);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			propFirstInstances[prop] = m_poInstanceBuffer->Allocate(propInstanceCounts[prop]);
+			SetInstances(m_propMeshDraws[prop], propFirstInstances[prop], propInstanceCounts[prop]);
+			propInstanceCounts[prop] = 0;
 		}
-		else
+
+		// The field is a root node, a node per row and a node per prop, so 
+		// moving the root moves every prop.
+		const float propSpacing = 1.2f;
+		m_uiPropFieldNode = m_poSceneGraph->CreateNode(SceneGraph::ms_uiNoParent,
+			glm::translate(glm::mat4(1.f), m_propFieldCentre));
+
+		for (unsigned int row = 0; row < propRows; ++row)
 		{
-			std::cout << "Failed to Load Model.\n";
-			return false;
+			const float rowOffset = ((float)row - 0.5f * (propRows - 1)) * propSpacing;
+			const unsigned int rowNode = m_poSceneGraph->CreateNode(m_uiPropFieldNode,
+				glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.f, rowOffset)));
+
+			for (unsigned int column = 0; column < propColumns; ++column)
+			{
+				const unsigned int prop = (row + column) % PROPS_COUNT;
+				const float columnOffset = ((float)column - 0.5f * (propColumns - 1)) * propSpacing;
+				// Vary the facing so the repetition is less obvious.
+				const float rotation = (float)((row * 7 + column * 13) % 8) * glm::quarter_pi<float>();
+				m_poSceneGraph->CreateNode(rowNode,
+					glm::rotate(glm::translate(glm::mat4(1.f), glm::vec3(columnOffset, 0.f, 0.f)),
+						rotation,
+						glm::vec3(0.f, 1.f, 0.f)),
+					propFirstInstances[prop] + propInstanceCounts[prop]++);
+			}
 		}
 	}
 
+	std::cout << "Instances: " << m_poInstanceBuffer->GetInstanceCount() <<
+		" OBJ instances in " << m_poSceneGraph->GetNodeCount() << " scene nodes";
+
+	if (m_bPropField)
+	{
+		std::cout << ", props drawn " << (m_bInstanceProps ? "instanced" : "individually") <<
+			", press 'I' to toggle and 'G' to spin the props";
+	}
+
+	std::cout << ". Press 'M' to toggle multi-draw, 'C' to toggle culling and 'B' to benchmark the BVH.\n";
+	// Copy every mesh to the GPU now, draws only reference it from here on.
+	if (!m_poGeometryStore->Upload())
+	{
+		std::cout << "Failed to upload model geometry.\n";
+		return false;
+	}
+
+	if (!m_poShaderConstants->Upload())
+	{
+		std::cout << "Failed to upload shader constants.\n";
+		return false;
+	}
+
 #ifdef NX64
 	// Unmount the file system and free the various memory.
 	nn::fs::Unmount(mountName);
@@ -272,7 +488,8 @@ bool Renderer::OnCreate()
 		skyboxFragmentShader);
 	// Set program to the skybox shader ID.
 	SetProgram(m_uiSkyboxProgram);
-	int skyboxUniformLocation = glGetUniformLocation(m_uiSkyboxProgram, "skybox");
+	int skyboxUniformLocation = ShaderUtilities::GetUniformLocation(m_uiSkyboxProgram,
+		ShaderUtilities::UNIFORMS_SKYBOX);
 	const GLsizei uniformScalar = 3;
 	glUniform1i(skyboxUniformLocation, uniformScalar);
 	return true;
@@ -281,10 +498,156 @@ bool Renderer::OnCreate()
 void Renderer::Update(float a_deltaTime)
 {
 	m_poDebugCamera->Move(a_deltaTime);
+#ifdef WIN64
+	static bool sbInstanceKeyDown = false;
+	static bool sbMultiDrawKeyDown = false;
+	static bool sbCullingKeyDown = false;
+	static bool sbSpinKeyDown = false;
+	static bool sbBenchmarkKeyDown = false;
+	static bool sbResidencyKeyDown = false;
+	static bool sbBindlessKeyDown = false;
+
+	// Benchmark toggles restart the draw time average.
+	if (m_bPropField && KeyPressed('I', sbInstanceKeyDown))
+	{
+		m_bInstanceProps = !m_bInstanceProps;
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+		std::cout << "Props drawn " << (m_bInstanceProps ? "instanced" : "individually") << ".\n";
+	}
+
+	if (KeyPressed('M', sbMultiDrawKeyDown))
+	{
+		m_poRenderQueue->SetMultiDraw(!m_poRenderQueue->IsMultiDraw());
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+		std::cout << "Draws submitted " << (m_poRenderQueue->IsMultiDraw() ? "with multi-draw" : "individually") <<
+			".\n";
+	}
+
+	if (KeyPressed('C', sbCullingKeyDown))
+	{
+		m_poFrustumCuller->SetEnabled(!m_poFrustumCuller->IsEnabled());
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+		std::cout << "Frustum culling " << (m_poFrustumCuller->IsEnabled() ? "enabled" : "disabled") << ".\n";
+	}
+
+	if (m_bPropField && KeyPressed('G', sbSpinKeyDown))
+	{
+		m_bSpinProps = !m_bSpinProps;
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+		std::cout << "Prop field " << (m_bSpinProps ? "spinning" : "stopped") << ".\n";
+	}
+
+	if (KeyPressed('B', sbBenchmarkKeyDown))
+	{
+		SceneBVH::Benchmark(m_poDebugCamera->GetProjectionViewMatrix());
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+	}
+
+	if (KeyPressed('T', sbResidencyKeyDown))
+	{
+		// A tight budget demotes and evicts textures as they're culled.
+		static size_t sOtherBudget = 8 * 1024 * 1024;
+		TextureManager* pTextureManager = TextureManager::GetInstance();
+		const size_t budget = pTextureManager->GetResidencyBudget();
+		pTextureManager->SetResidencyBudget(sOtherBudget);
+		sOtherBudget = budget;
+		std::cout << "Texture residency budget " << pTextureManager->GetResidencyBudget() / (1024 * 1024) <<
+			"MB.\n";
+	}
+
+	if (KeyPressed('H', sbBindlessKeyDown))
+	{
+		TextureManager* pTextureManager = TextureManager::GetInstance();
+		pTextureManager->SetBindless(!pTextureManager->IsBindless());
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+		std::cout << "Textures " << (pTextureManager->IsBindless() ? "bindless" : "bound per draw") << ".\n";
+	}
+
+	static bool sbPickButtonDown = false;
+	GLFWwindow* pWindow = glfwGetCurrentContext();
+
+	if (glfwGetMouseButton(pWindow, GLFW_MOUSE_BUTTON_1) != GLFW_PRESS)
+	{
+		sbPickButtonDown = false;
+	}
+	else if (!sbPickButtonDown)
+	{
+		sbPickButtonDown = true;
+		double cursorX = 0.0;
+		double cursorY = 0.0;
+		int windowWidth = 0;
+		int windowHeight = 0;
+		glfwGetCursorPos(pWindow, &cursorX, &cursorY);
+		glfwGetWindowSize(pWindow, &windowWidth, &windowHeight);
+		const std::chrono::high_resolution_clock::time_point pickStart = std::chrono::high_resolution_clock::now();
+		ScenePicker::Hit hit;
+		const bool bHit = windowWidth > 0 && windowHeight > 0 &&
+			m_poScenePicker->Pick((float)cursorX,
+				(float)cursorY,
+				(float)windowWidth,
+				(float)windowHeight,
+				m_poDebugCamera->GetProjectionViewMatrix(),
+				hit);
+		const std::chrono::duration<double> pickTime = std::chrono::high_resolution_clock::now() - pickStart;
+
+		if (bHit)
+		{
+			std::cout << "Picked " << hit.pModel->GetMeshByIndex(hit.mesh)->GetName() <<
+				" instance " << hit.instance <<
+				", triangle " << hit.triangle <<
+				" at (" << hit.barycentrics.x << ", " << hit.barycentrics.y << ", " << hit.barycentrics.z <<
+				"), " << hit.distance << " units away in " <<
+				pickTime.count() * 1000.0 << "ms.\n";
+		}
+		else
+		{
+			std::cout << "Picked nothing in " << pickTime.count() * 1000.0 << "ms.\n";
+		}
+	}
+#endif // WIN64.
+
+	if (m_bSpinProps)
+	{
+		// Only the root changes, the scene graph carries it down to every 
+		// prop.
+		const float spinSpeed = 0.2f;
+		m_fPropFieldAngle += spinSpeed * a_deltaTime;
+		m_poSceneGraph->SetLocalTransform(m_uiPropFieldNode,
+			glm::rotate(glm::translate(glm::mat4(1.f), m_propFieldCentre),
+				m_fPropFieldAngle,
+				glm::vec3(0.f, 1.f, 0.f)));
+	}
 }
 
+#ifdef WIN64
+// True on the frame a key goes down. The flag tracks the key between calls.
+bool Renderer::KeyPressed(int a_key, bool& a_bKeyDown)
+{
+	if (glfwGetKey(glfwGetCurrentContext(), a_key) != GLFW_PRESS)
+	{
+		a_bKeyDown = false;
+		return false;
+	}
+
+	if (a_bKeyDown)
+	{
+		return false;
+	}
+
+	a_bKeyDown = true;
+	return true;
+}
+#endif // WIN64.
+
 void Renderer::Draw()
 {
+	const std::chrono::high_resolution_clock::time_point drawStart = std::chrono::high_resolution_clock::now();
 	// Set render window's background colour.
 	float redValue = 0.5f;
 	float greenValue = 0.45f;
@@ -292,6 +655,18 @@ void Renderer::Draw()
 	float alphaValue = 1.f;
 	glClearColor(redValue, greenValue, blueValue, alphaValue);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	// Textures decoded in the background replace their placeholders.
+	TextureManager::GetInstance()->FinalizeTextures();
+	// Camera data is written once and read by every program this frame.
+	m_poDebugCamera->UpdateProjectionView();
+	m_poShaderConstants->UpdateFrame(m_poDebugCamera->GetProjectionViewMatrix(),
+		m_poDebugCamera->GetCameraMatrix()[3]);
+	m_poShaderConstants->Bind();
+	// Culling reads the instance transforms, so they must be current first.
+	const unsigned int nodesUpdated = m_poSceneGraph->UpdateWorldTransforms(m_poInstanceBuffer);
+	m_uiNodesUpdated += nodesUpdated;
+	// Culling runs on the CPU before any OBJ draw is queued.
+	m_poFrustumCuller->Begin(m_poDebugCamera->GetProjectionViewMatrix(), nodesUpdated > 0, (float)GetWindowHeight());
 
 	glDepthMask(GL_FALSE);
 	SetProgram(m_uiSkyboxProgram);
@@ -304,12 +679,14 @@ void Renderer::Draw()
 		up);
 	// Value of 1 specifies target variable to modify is not an array.
 	const unsigned int matricesToModify = 1;
-	int viewLocation = glGetUniformLocation(GetProgram(), "view");
+	int viewLocation = ShaderUtilities::GetUniformLocation(GetProgram(),
+		ShaderUtilities::UNIFORMS_VIEW);
 	glUniformMatrix4fv(viewLocation,
 		matricesToModify,
 		GL_FALSE,
 		&cubeDirection[0][0]);
-	int projectionViewLocation = glGetUniformLocation(GetProgram(), "projection");
+	int projectionViewLocation = ShaderUtilities::GetUniformLocation(GetProgram(),
+		ShaderUtilities::UNIFORMS_PROJECTION);
 	glUniformMatrix4fv(projectionViewLocation,
 		matricesToModify,
 		GL_FALSE,
@@ -324,108 +701,73 @@ void Renderer::Draw()
 	// Enable shaders.
 	SetProgram(m_uiProgram);
 	glBindVertexArray(m_uiLinesVAO);
-	m_poDebugCamera->UpdateProjectionView();
 	const GLsizei gridIndices = 42 * 2;
 	glDrawArrays(GL_LINES, 0, gridIndices);
 	glBindVertexArray(0);
 	SetProgram(0);
-	SetProgram(m_uiOBJProgram);
-	glBindVertexArray(m_uiOBJModelVAO);
-	m_poDebugCamera->UpdateProjectionView();
+	glBindVertexArray(m_poGeometryStore->GetVAO());
+
+	for (unsigned int model = 0; model < m_uiNumberOfModels; ++model)
+	{
+		for (auto iterator = m_objMeshDraws[model].begin(); iterator != m_objMeshDraws[model].end(); ++iterator)
+		{
+			m_poFrustumCuller->Add(*iterator);
+		}
+	}
 
-	for (unsigned int model = 0; model < m_uiNumberOfModels; ++model) {
-		for (unsigned int i = 0; i < m_poOBJModels[model]->GetMeshCount(); ++i)
+	for (unsigned int prop = 0; prop < PROPS_COUNT; ++prop)
+	{
+		for (auto iterator = m_propMeshDraws[prop].begin(); iterator != m_propMeshDraws[prop].end(); ++iterator)
 		{
-			// Get the model matrix location from the shader program.
-			int modelMatrixUnifromLocation =
-				glGetUniformLocation(m_uiCurrentProgram, "modelMatrix");
-			// Send the OBJ model's world matrix data across to the shader program.
-			glUniformMatrix4fv(modelMatrixUnifromLocation,
-				matricesToModify,
-				false,
-				glm::value_ptr(GetModel(model)->GetWorldMatrix()));
-			m_poDebugCamera->UpdateCameraPosition();
-
-			OBJMesh* pMesh = m_poOBJModels[model]->GetMeshByIndex(i);
-			OBJMaterial* pMaterial = pMesh->GetMaterial();
-			// Send material data to shader.
-			int kALocation = glGetUniformLocation(m_uiOBJProgram, "kA");
-			int kDLocation = glGetUniformLocation(m_uiOBJProgram, "kD");
-			int kSLocation = glGetUniformLocation(m_uiOBJProgram, "kS");
-
-			if (pMaterial)
+			if (m_bInstanceProps)
 			{
-				const GLsizei elementsToModify = 1;
-				// Send the OBJ model's world data across to the shader program.
-				glUniform4fv(kALocation,
-					elementsToModify,
-					glm::value_ptr(*pMaterial->GetKA()));
-				glUniform4fv(kDLocation,
-					elementsToModify,
-					glm::value_ptr(*pMaterial->GetKD()));
-				glUniform4fv(kSLocation,
-					elementsToModify,
-					glm::value_ptr(*pMaterial->GetKS()));
-
-				// Get the location of the diffuse texture.
-				int textureUniformLocation = glGetUniformLocation(m_uiOBJProgram,
-					"diffuseTexture");
-				// Set diffuse texture to be GL_Texture0.
-				glUniform1i(textureUniformLocation, 0);
-				// Set the active texture unit to texture0.
-				glActiveTexture(GL_TEXTURE0);
-				// Bind the texture for diffuse for this material to the texture0.
-				glBindTexture(GL_TEXTURE_2D,
-					pMaterial->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_DIFFUSE));
-				textureUniformLocation = glGetUniformLocation(m_uiOBJProgram,
-					"specularTexture");
-				glUniform1i(textureUniformLocation, 1);
-				glActiveTexture(GL_TEXTURE1);
-				glBindTexture(GL_TEXTURE_2D,
-					pMaterial->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_SPECULAR));
-				textureUniformLocation = glGetUniformLocation(m_uiOBJProgram,
-					"normalTexture");
-				glUniform1i(textureUniformLocation, 2);
-				glActiveTexture(GL_TEXTURE2);
-				glBindTexture(GL_TEXTURE_2D,
-					pMaterial->GetTextureID(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_NORMAL));
+				m_poFrustumCuller->Add(*iterator);
+				continue;
 			}
-			// No material to obtain lighting information from so use defaults.
-			else
+
+			// Benchmark baseline, one draw per instance.
+			RenderQueue::DrawItem instanceDraw = *iterator;
+			instanceDraw.instanceCount = 1;
+
+			for (unsigned int i = 0; i < iterator->instanceCount; ++i)
 			{
-				// Elements to modify. 1 indicates we're not modifying an array.
-				const GLsizei elementsToModify = 1;
-				// Send the OBJ model's world matrix data across to the shader program.
-				glUniform4fv(kALocation,
-					 elementsToModify,
-					glm::value_ptr(glm::vec4(0.25f, 0.25f, 0.25f, 1.f)));
-				glUniform4fv(kDLocation,
-					 elementsToModify,
-					glm::value_ptr(glm::vec4(1.f, 1.f, 1.f, 1.f)));
-				glUniform4fv(kSLocation,
-					 elementsToModify,
-					glm::value_ptr(glm::vec4(1.f, 1.f, 1.f, 64.f)));
+				instanceDraw.firstInstance = iterator->firstInstance + i;
+				m_poFrustumCuller->Add(instanceDraw);
 			}
-
-			glBindBuffer(GL_ARRAY_BUFFER, m_uiOBJModelBuffer[0]);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiOBJModelBuffer[1]);
-			glBufferData(GL_ARRAY_BUFFER,
-				pMesh->GetVertices()->size() * sizeof(OBJVertex),
-				pMesh->GetVertices()->data(),
-				GL_STATIC_DRAW);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiOBJModelBuffer[1]);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-				pMesh->GetIndices()->size() * sizeof(unsigned int),
-				pMesh->GetIndices()->data(),
-				GL_STATIC_DRAW);
-			glDrawElements(GL_TRIANGLES,
-				(GLsizei)pMesh->GetIndices()->size(),
-				GL_UNSIGNED_INT, 0);
 		}
 	}
 
+	m_poFrustumCuller->Submit(m_poRenderQueue);
+	m_poInstanceBuffer->Upload();
+	m_poInstanceBuffer->Bind();
+	m_poFrustumCuller->Bind();
+	// Draws in state order and binds the OBJ program itself.
+	m_poRenderQueue->Execute(m_poGeometryStore);
 	glBindVertexArray(0);
 	SetProgram(0);
+	const std::chrono::duration<double> drawTime = std::chrono::high_resolution_clock::now() - drawStart;
+	m_dDrawSeconds += drawTime.count();
+	const unsigned int framesPerReport = 120;
+
+	if (++m_uiDrawFrames == framesPerReport)
+	{
+		const RenderQueue::Statistics& statistics = m_poRenderQueue->GetFrameStatistics();
+		const FrustumCuller::Statistics& culling = m_poFrustumCuller->GetFrameStatistics();
+		const TextureManager::Statistics& textures = TextureManager::GetInstance()->GetStatistics();
+		std::cout << "Draw CPU time: " << m_dDrawSeconds * 1000.0 / m_uiDrawFrames << " ms per frame, " <<
+			statistics.draws << " draws of " << statistics.instances << " instances in " <<
+			statistics.drawCalls << " calls (props " << (m_bInstanceProps ? "instanced" : "individual") <<
+			(m_poRenderQueue->IsMultiDraw() ? ", multi-draw" : "") << "), " << statistics.textureBinds <<
+			" texture binds" << (TextureManager::GetInstance()->IsBindless() ? " (bindless)" : "") << ". Culling " <<
+			(m_poFrustumCuller->IsEnabled() ? "on" : "off") << ": " <<
+			culling.instancesVisible << " instances visible, " << culling.instancesCulled << " culled (" <<
+			culling.spheresTested << " tested past the BVH), " <<
+			culling.drawsCulled << " draws skipped. " << m_uiNodesUpdated / m_uiDrawFrames <<
+			" scene nodes updated per frame. " << textures.residentBytes / 1024 << "KB of textures resident.\n";
+		m_dDrawSeconds = 0.0;
+		m_uiDrawFrames = 0;
+		m_uiNodesUpdated = 0;
+	}
 }
 
 void Renderer::Destroy()
@@ -439,15 +781,55 @@ void Renderer::Destroy()
 		m_poOBJModels[model] = nullptr;
 	}
 
+	for (unsigned int prop = 0; prop < PROPS_COUNT; ++prop)
+	{
+		delete m_poPropModels[prop];
+		m_poPropModels[prop] = nullptr;
+	}
+
+	delete m_poScenePicker;
+	m_poScenePicker = nullptr;
+	delete m_poSceneGraph;
+	m_poSceneGraph = nullptr;
+	delete m_poFrustumCuller;
+	m_poFrustumCuller = nullptr;
+	delete m_poInstanceBuffer;
+	m_poInstanceBuffer = nullptr;
+
+	delete m_poGeometryStore;
+	m_poGeometryStore = nullptr;
+	delete m_poShaderConstants;
+	m_poShaderConstants = nullptr;
+	const RenderQueue::Statistics& statistics = m_poRenderQueue->GetTotalStatistics();
+	std::cout << "Render queue: " << statistics.draws << " draws of " <<
+		statistics.instances << " instances in " <<
+		statistics.drawCalls << " calls, avoided " <<
+		statistics.programBindsAvoided << " program binds and " <<
+		statistics.textureBindsAvoided << " texture binds (" <<
+		statistics.textureBinds << " made)." << std::endl;
+	delete m_poRenderQueue;
+	m_poRenderQueue = nullptr;
 	delete[] m_pLines;
 	m_pLines = nullptr;
 	glDeleteBuffers(1, &m_uiLineVBO);
-	glDeleteBuffers(2, m_uiOBJModelBuffer);
 	glDeleteVertexArrays(1, &m_uiLinesVAO);
-	glDeleteVertexArrays(1, &m_uiOBJModelVAO);
 	ShaderUtilities::DeleteProgram(m_uiSkyboxProgram);
 	ShaderUtilities::DeleteProgram(m_uiOBJProgram);
 	ShaderUtilities::DeleteProgram(m_uiProgram);
 	ShaderUtilities::DestroyInstance();
+	const TextureManager::Statistics& textures = TextureManager::GetInstance()->GetStatistics();
+	std::cout << "Texture residency: " << textures.hits << " hits, " <<
+		textures.misses << " misses, " <<
+		textures.demotions << " demotions, " <<
+		textures.evictions << " evictions, " <<
+		textures.loads << " loads reading " <<
+		textures.bytesRequested / 1024 << "KB of mips, peak " <<
+		textures.peakResidentBytes / 1024 << "KB resident, " <<
+		textures.tableUpdates << " texture table updates, " <<
+		textures.atlasedTextures << " textures packed into " <<
+		textures.atlases << " atlases, " <<
+		textures.sharedTextures << " files sharing a texture by contents saving " <<
+		textures.sharedFileBytes / 1024 << "KB of decoding and " <<
+		textures.sharedResidentBytes / 1024 << "KB resident." << std::endl;
 	TextureManager::DestroyInstance();
 }
\ No newline at end of file
@@ -0,0 +1,515 @@
+//////////////////////////////
+// File: SceneBVH.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "SceneBVH.h" // File's header.
+#include <algorithm>
+#include <chrono>
+#include "FrustumCuller.h"
+#include <iostream>
+#include <limits>
+#include <random>
+
+const unsigned int SceneBVH::ms_uiBinCount;
+const unsigned int SceneBVH::ms_uiMinLeafItems;
+const unsigned int SceneBVH::ms_uiMaxLeafItems;
+
+SceneBVH::SceneBVH() : m_nodes(),
+	m_items(),
+	m_boxes(),
+	m_centres()
+{}
+
+SceneBVH::~SceneBVH()
+{}
+
+// Builds the hierarchy over the boxes, items are the boxes' indices.
+void SceneBVH::Build(const std::vector<Box>& a_boxes)
+{
+	const unsigned int itemCount = (unsigned int)a_boxes.size();
+	m_boxes = a_boxes;
+	m_centres.resize(itemCount);
+	m_items.resize(itemCount);
+	m_nodes.clear();
+
+	for (unsigned int i = 0; i < itemCount; ++i)
+	{
+		m_centres[i] = (a_boxes[i].min + a_boxes[i].max) * 0.5f;
+		m_items[i] = i;
+	}
+
+	if (itemCount == 0)
+	{
+		return;
+	}
+
+	// A binary tree never needs more than twice its item count in nodes.
+	m_nodes.reserve(itemCount * 2);
+	Node root;
+	root.first = 0;
+	root.count = itemCount;
+	m_nodes.push_back(root);
+	Subdivide(0);
+}
+
+// Updates every node's bounds for boxes that moved, keeping the tree's 
+// shape. The box count must match the last build.
+void SceneBVH::Refit(const std::vector<Box>& a_boxes)
+{
+	m_boxes = a_boxes;
+
+	// Children are always stored after their parent, so walking backwards 
+	// finishes both children before their parent is reached.
+	for (unsigned int i = (unsigned int)m_nodes.size(); i-- > 0;)
+	{
+		Node& node = m_nodes[i];
+
+		if (node.count > 0)
+		{
+			node.min = glm::vec3(std::numeric_limits<float>::max());
+			node.max = glm::vec3(-std::numeric_limits<float>::max());
+
+			for (unsigned int item = node.first; item < node.first + node.count; ++item)
+			{
+				node.min = glm::min(node.min, m_boxes[m_items[item]].min);
+				node.max = glm::max(node.max, m_boxes[m_items[item]].max);
+			}
+		}
+		else
+		{
+			node.min = glm::min(m_nodes[node.first].min, m_nodes[node.first + 1].min);
+			node.max = glm::max(m_nodes[node.first].max, m_nodes[node.first + 1].max);
+		}
+	}
+}
+
+// Finds the items whose boxes touch the frustum, given as inward facing 
+// normalized planes. Items in nodes wholly inside the frustum are added to 
+// the inside list, the rest touch a plane and may still be outside.
+void SceneBVH::QueryFrustum(const glm::vec4* a_pPlanes,
+	unsigned int a_planeCount,
+	std::vector<unsigned int>& a_inside,
+	std::vector<unsigned int>& a_intersecting) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	const unsigned int maxDepth = 64;
+	unsigned int stack[maxDepth];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		bool bOutside = false;
+		bool bInside = true;
+
+		for (unsigned int plane = 0; plane < a_planeCount && !bOutside; ++plane)
+		{
+			const glm::vec4& p = a_pPlanes[plane];
+			// The corners furthest along and furthest against the plane's 
+			// normal decide whether the box is outside, inside or crossing it.
+			const glm::vec3 furthest(p.x > 0.f ? node.max.x : node.min.x,
+				p.y > 0.f ? node.max.y : node.min.y,
+				p.z > 0.f ? node.max.z : node.min.z);
+			const glm::vec3 nearest(p.x > 0.f ? node.min.x : node.max.x,
+				p.y > 0.f ? node.min.y : node.max.y,
+				p.z > 0.f ? node.min.z : node.max.z);
+			bOutside = glm::dot(glm::vec3(p), furthest) + p.w < 0.f;
+			bInside = bInside && glm::dot(glm::vec3(p), nearest) + p.w >= 0.f;
+		}
+
+		if (bOutside)
+		{
+			continue;
+		}
+
+		if (bInside)
+		{
+			AddSubtree((unsigned int)(&node - m_nodes.data()), a_inside);
+		}
+		else if (node.count > 0)
+		{
+			a_intersecting.insert(a_intersecting.end(),
+				m_items.begin() + node.first,
+				m_items.begin() + node.first + node.count);
+		}
+		else
+		{
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = node.first + 1;
+		}
+	}
+}
+
+// Finds the items whose boxes the ray passes through within the maximum 
+// distance, nearest entry first.
+void SceneBVH::QueryRay(const glm::vec3& a_origin,
+	const glm::vec3& a_direction,
+	float a_maxDistance,
+	std::vector<RayHit>& a_hits) const
+{
+	a_hits.clear();
+
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	// Zero components give infinities, which the slab test handles.
+	const glm::vec3 inverseDirection = 1.f / a_direction;
+	const unsigned int maxDepth = 64;
+	unsigned int stack[maxDepth];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		const glm::vec3 t0 = (node.min - a_origin) * inverseDirection;
+		const glm::vec3 t1 = (node.max - a_origin) * inverseDirection;
+		const glm::vec3 tNear = glm::min(t0, t1);
+		const glm::vec3 tFar = glm::max(t0, t1);
+		const float entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.f));
+		const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, a_maxDistance));
+
+		if (entry > exit)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = node.first + 1;
+			continue;
+		}
+
+		for (unsigned int i = node.first; i < node.first + node.count; ++i)
+		{
+			const Box& box = m_boxes[m_items[i]];
+			const glm::vec3 b0 = (box.min - a_origin) * inverseDirection;
+			const glm::vec3 b1 = (box.max - a_origin) * inverseDirection;
+			const glm::vec3 bNear = glm::min(b0, b1);
+			const glm::vec3 bFar = glm::max(b0, b1);
+			const float boxEntry = std::max(std::max(bNear.x, bNear.y), std::max(bNear.z, 0.f));
+			const float boxExit = std::min(std::min(bFar.x, bFar.y), std::min(bFar.z, a_maxDistance));
+
+			if (boxEntry <= boxExit)
+			{
+				RayHit hit;
+				hit.item = m_items[i];
+				hit.distance = boxEntry;
+				a_hits.push_back(hit);
+			}
+		}
+	}
+
+	std::sort(a_hits.begin(), a_hits.end(), [](const RayHit& a_lhs, const RayHit& a_rhs)
+	{
+		return a_lhs.distance < a_rhs.distance;
+	});
+}
+
+unsigned int SceneBVH::GetItemCount() const
+{
+	return (unsigned int)m_items.size();
+}
+
+unsigned int SceneBVH::GetNodeCount() const
+{
+	return (unsigned int)m_nodes.size();
+}
+
+// Node 0 is the root. Leaves' item ranges index GetItem.
+const SceneBVH::Node& SceneBVH::GetNode(unsigned int a_node) const
+{
+	return m_nodes[a_node];
+}
+
+unsigned int SceneBVH::GetItem(unsigned int a_index) const
+{
+	return m_items[a_index];
+}
+
+// Times building, refitting and querying random scenes of 1k, 10k and 100k 
+// boxes seen through the given camera.
+void SceneBVH::Benchmark(const glm::mat4& a_projectionViewMatrix)
+{
+	glm::vec4 planes[FrustumCuller::PLANES_COUNT];
+	FrustumCuller::ExtractPlanes(a_projectionViewMatrix, planes);
+	const glm::vec3 cameraPosition = glm::vec3(glm::inverse(a_projectionViewMatrix) * glm::vec4(0.f, 0.f, -1.f, 1.f));
+	const unsigned int sceneSizes[] = { 1000, 10000, 100000 };
+	const unsigned int queryRepeats = 100;
+	const unsigned int rayCount = 1000;
+	// Fixed seed so runs are comparable.
+	std::mt19937 generator(5036);
+	typedef std::chrono::high_resolution_clock Clock;
+
+	for (unsigned int size = 0; size < sizeof(sceneSizes) / sizeof(sceneSizes[0]); ++size)
+	{
+		const unsigned int boxCount = sceneSizes[size];
+		// Keep the density the same at every size, like a growing level.
+		const float halfExtent = 0.6f * std::sqrt((float)boxCount);
+		std::uniform_real_distribution<float> spread(-halfExtent, halfExtent);
+		std::uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+		std::uniform_real_distribution<float> unit(-1.f, 1.f);
+		std::vector<Box> boxes(boxCount);
+
+		for (unsigned int i = 0; i < boxCount; ++i)
+		{
+			const glm::vec3 centre(spread(generator), 0.5f, spread(generator));
+			boxes[i].min = centre - glm::vec3(0.5f);
+			boxes[i].max = centre + glm::vec3(0.5f);
+		}
+
+		SceneBVH bvh;
+		Clock::time_point start = Clock::now();
+		bvh.Build(boxes);
+		const double buildTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+		for (unsigned int i = 0; i < boxCount; ++i)
+		{
+			const glm::vec3 offset(jitter(generator), 0.f, jitter(generator));
+			boxes[i].min += offset;
+			boxes[i].max += offset;
+		}
+
+		start = Clock::now();
+		bvh.Refit(boxes);
+		const double refitTime = std::chrono::duration<double>(Clock::now() - start).count();
+		std::vector<unsigned int> inside;
+		std::vector<unsigned int> intersecting;
+		start = Clock::now();
+
+		for (unsigned int repeat = 0; repeat < queryRepeats; ++repeat)
+		{
+			inside.clear();
+			intersecting.clear();
+			bvh.QueryFrustum(planes, FrustumCuller::PLANES_COUNT, inside, intersecting);
+		}
+
+		const double frustumTime = std::chrono::duration<double>(Clock::now() - start).count() / queryRepeats;
+		// Brute force test of every box for comparison.
+		unsigned int linearVisible = 0;
+		start = Clock::now();
+
+		for (unsigned int repeat = 0; repeat < queryRepeats; ++repeat)
+		{
+			linearVisible = 0;
+
+			for (unsigned int i = 0; i < boxCount; ++i)
+			{
+				bool bOutside = false;
+
+				for (unsigned int plane = 0; plane < FrustumCuller::PLANES_COUNT && !bOutside; ++plane)
+				{
+					const glm::vec4& p = planes[plane];
+					const glm::vec3 furthest(p.x > 0.f ? boxes[i].max.x : boxes[i].min.x,
+						p.y > 0.f ? boxes[i].max.y : boxes[i].min.y,
+						p.z > 0.f ? boxes[i].max.z : boxes[i].min.z);
+					bOutside = glm::dot(glm::vec3(p), furthest) + p.w < 0.f;
+				}
+
+				linearVisible += bOutside ? 0 : 1;
+			}
+		}
+
+		const double linearTime = std::chrono::duration<double>(Clock::now() - start).count() / queryRepeats;
+		std::vector<RayHit> hits;
+		unsigned int rayHits = 0;
+		start = Clock::now();
+
+		for (unsigned int ray = 0; ray < rayCount; ++ray)
+		{
+			glm::vec3 direction(unit(generator), unit(generator) * 0.25f - 0.5f, unit(generator));
+			bvh.QueryRay(cameraPosition, glm::normalize(direction), 1000.f, hits);
+			rayHits += hits.empty() ? 0 : 1;
+		}
+
+		const double rayTime = std::chrono::duration<double>(Clock::now() - start).count() / rayCount;
+		std::cout << "BVH " << boxCount << " boxes, " << bvh.GetNodeCount() << " nodes: build " <<
+			buildTime * 1000.0 << " ms, refit " << refitTime * 1000.0 << " ms, frustum " <<
+			frustumTime * 1000.0 << " ms (" << inside.size() << " inside, " << intersecting.size() <<
+			" crossing; linear " << linearTime * 1000.0 << " ms, " << linearVisible << " visible), ray " <<
+			rayTime * 1000000.0 << " us (" << rayHits << "/" << rayCount << " hit)." << std::endl;
+	}
+}
+
+void SceneBVH::Subdivide(unsigned int a_node)
+{
+	Node& node = m_nodes[a_node];
+	node.min = glm::vec3(std::numeric_limits<float>::max());
+	node.max = glm::vec3(-std::numeric_limits<float>::max());
+	glm::vec3 centreMin(std::numeric_limits<float>::max());
+	glm::vec3 centreMax(-std::numeric_limits<float>::max());
+
+	for (unsigned int i = node.first; i < node.first + node.count; ++i)
+	{
+		const unsigned int item = m_items[i];
+		node.min = glm::min(node.min, m_boxes[item].min);
+		node.max = glm::max(node.max, m_boxes[item].max);
+		centreMin = glm::min(centreMin, m_centres[item]);
+		centreMax = glm::max(centreMax, m_centres[item]);
+	}
+
+	if (node.count <= ms_uiMinLeafItems)
+	{
+		return;
+	}
+
+	// Find the cheapest split, where cost is each side's item count times 
+	// its surface area.
+	float bestCost = std::numeric_limits<float>::max();
+	int bestAxis = -1;
+	unsigned int bestBin = 0;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const float extent = centreMax[axis] - centreMin[axis];
+
+		if (extent <= 0.f)
+		{
+			continue;
+		}
+
+		unsigned int binCounts[ms_uiBinCount] = {};
+		glm::vec3 binMin[ms_uiBinCount];
+		glm::vec3 binMax[ms_uiBinCount];
+		const float binScale = ms_uiBinCount / extent;
+
+		for (unsigned int bin = 0; bin < ms_uiBinCount; ++bin)
+		{
+			binMin[bin] = glm::vec3(std::numeric_limits<float>::max());
+			binMax[bin] = glm::vec3(-std::numeric_limits<float>::max());
+		}
+
+		for (unsigned int i = node.first; i < node.first + node.count; ++i)
+		{
+			const unsigned int item = m_items[i];
+			const unsigned int bin = std::min(ms_uiBinCount - 1,
+				(unsigned int)((m_centres[item][axis] - centreMin[axis]) * binScale));
+			++binCounts[bin];
+			binMin[bin] = glm::min(binMin[bin], m_boxes[item].min);
+			binMax[bin] = glm::max(binMax[bin], m_boxes[item].max);
+		}
+
+		// Sweep from the left storing each split's left side, then from the 
+		// right to cost every split.
+		float leftAreas[ms_uiBinCount - 1];
+		unsigned int leftCounts[ms_uiBinCount - 1];
+		glm::vec3 sweepMin(std::numeric_limits<float>::max());
+		glm::vec3 sweepMax(-std::numeric_limits<float>::max());
+		unsigned int sweepCount = 0;
+
+		for (unsigned int bin = 0; bin < ms_uiBinCount - 1; ++bin)
+		{
+			sweepCount += binCounts[bin];
+			sweepMin = glm::min(sweepMin, binMin[bin]);
+			sweepMax = glm::max(sweepMax, binMax[bin]);
+			leftCounts[bin] = sweepCount;
+			leftAreas[bin] = sweepCount > 0 ? SurfaceArea(sweepMin, sweepMax) : 0.f;
+		}
+
+		sweepMin = glm::vec3(std::numeric_limits<float>::max());
+		sweepMax = glm::vec3(-std::numeric_limits<float>::max());
+		sweepCount = 0;
+
+		for (unsigned int bin = ms_uiBinCount - 1; bin > 0; --bin)
+		{
+			sweepCount += binCounts[bin];
+			sweepMin = glm::min(sweepMin, binMin[bin]);
+			sweepMax = glm::max(sweepMax, binMax[bin]);
+			const float rightArea = sweepCount > 0 ? SurfaceArea(sweepMin, sweepMax) : 0.f;
+			const float cost = leftCounts[bin - 1] * leftAreas[bin - 1] + sweepCount * rightArea;
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = bin;
+			}
+		}
+	}
+
+	// Every centre is in the same place, so no split can separate them.
+	if (bestAxis < 0)
+	{
+		return;
+	}
+
+	const float leafCost = node.count * SurfaceArea(node.min, node.max);
+
+	if (bestCost >= leafCost && node.count <= ms_uiMaxLeafItems)
+	{
+		return;
+	}
+
+	// Items in bins left of the split go first.
+	const float binScale = ms_uiBinCount / (centreMax[bestAxis] - centreMin[bestAxis]);
+	unsigned int i = node.first;
+	unsigned int j = node.first + node.count;
+
+	while (i < j)
+	{
+		const unsigned int bin = std::min(ms_uiBinCount - 1,
+			(unsigned int)((m_centres[m_items[i]][bestAxis] - centreMin[bestAxis]) * binScale));
+
+		if (bin < bestBin)
+		{
+			++i;
+		}
+		else
+		{
+			std::swap(m_items[i], m_items[--j]);
+		}
+	}
+
+	const unsigned int leftCount = i - node.first;
+
+	if (leftCount == 0 || leftCount == node.count)
+	{
+		return;
+	}
+
+	// Space was reserved up front, so pushing doesn't move the node.
+	const unsigned int leftChild = (unsigned int)m_nodes.size();
+	Node left;
+	left.first = node.first;
+	left.count = leftCount;
+	Node right;
+	right.first = i;
+	right.count = node.count - leftCount;
+	m_nodes.push_back(left);
+	m_nodes.push_back(right);
+	node.first = leftChild;
+	node.count = 0;
+	Subdivide(leftChild);
+	Subdivide(leftChild + 1);
+}
+
+// Adds every item below a node to the list.
+void SceneBVH::AddSubtree(unsigned int a_node, std::vector<unsigned int>& a_items) const
+{
+	const Node& node = m_nodes[a_node];
+
+	if (node.count > 0)
+	{
+		a_items.insert(a_items.end(), m_items.begin() + node.first, m_items.begin() + node.first + node.count);
+		return;
+	}
+
+	AddSubtree(node.first, a_items);
+	AddSubtree(node.first + 1, a_items);
+}
+
+float SceneBVH::SurfaceArea(const glm::vec3& a_min, const glm::vec3& a_max)
+{
+	const glm::vec3 size = a_max - a_min;
+	return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
@@ -0,0 +1,113 @@
+//////////////////////////////
+// File: SceneGraph.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "SceneGraph.h" // File's header.
+#include <algorithm>
+#include "InstanceBuffer.h"
+
+const unsigned int SceneGraph::ms_uiNoParent = 0xFFFFFFFF;
+const unsigned int SceneGraph::ms_uiNoInstance = 0xFFFFFFFF;
+
+SceneGraph::SceneGraph() : m_uiFirstDirty(0),
+	m_parents(),
+	m_instances(),
+	m_dirty(),
+	m_localTransforms(),
+	m_worldTransforms()
+{}
+
+SceneGraph::~SceneGraph()
+{}
+
+// Adds a node below a parent, or at the root, and returns its index. A node 
+// with an instance has its world transform copied into that slot of the 
+// instance buffer whenever it changes.
+unsigned int SceneGraph::CreateNode(unsigned int a_parent,
+	const glm::mat4& a_localTransform,
+	unsigned int a_instance)
+{
+	const unsigned int node = (unsigned int)m_parents.size();
+	m_parents.push_back(a_parent);
+	m_instances.push_back(a_instance);
+	m_dirty.push_back(1);
+	m_localTransforms.push_back(a_localTransform);
+	m_worldTransforms.push_back(a_localTransform);
+	m_uiFirstDirty = std::min(m_uiFirstDirty, node);
+	return node;
+}
+
+void SceneGraph::SetLocalTransform(unsigned int a_node, const glm::mat4& a_localTransform)
+{
+	m_localTransforms[a_node] = a_localTransform;
+	m_dirty[a_node] = 1;
+	m_uiFirstDirty = std::min(m_uiFirstDirty, a_node);
+}
+
+const glm::mat4& SceneGraph::GetLocalTransform(unsigned int a_node) const
+{
+	return m_localTransforms[a_node];
+}
+
+// Only up to date after UpdateWorldTransforms.
+const glm::mat4& SceneGraph::GetWorldTransform(unsigned int a_node) const
+{
+	return m_worldTransforms[a_node];
+}
+
+unsigned int SceneGraph::GetParent(unsigned int a_node) const
+{
+	return m_parents[a_node];
+}
+
+unsigned int SceneGraph::GetNodeCount() const
+{
+	return (unsigned int)m_parents.size();
+}
+
+// Recomputes the world transform of every dirty node and its descendants and 
+// returns how many were recomputed.
+unsigned int SceneGraph::UpdateWorldTransforms(InstanceBuffer* a_pInstanceBuffer)
+{
+	const unsigned int nodeCount = (unsigned int)m_parents.size();
+	unsigned int updated = 0;
+
+	// Parents come before their children, so a parent's flag is final by the 
+	// time its children read it and one pass covers every dirty subtree.
+	for (unsigned int node = m_uiFirstDirty; node < nodeCount; ++node)
+	{
+		const unsigned int parent = m_parents[node];
+
+		if (parent != ms_uiNoParent)
+		{
+			m_dirty[node] |= m_dirty[parent];
+		}
+
+		if (!m_dirty[node])
+		{
+			continue;
+		}
+
+		m_worldTransforms[node] = parent != ms_uiNoParent ?
+			m_worldTransforms[parent] * m_localTransforms[node] :
+			m_localTransforms[node];
+
+		if (m_instances[node] != ms_uiNoInstance)
+		{
+			a_pInstanceBuffer->SetTransform(m_instances[node], m_worldTransforms[node]);
+		}
+
+		++updated;
+	}
+
+	// Flags are cleared after the pass as children read their parent's.
+	if (m_uiFirstDirty < nodeCount)
+	{
+		std::fill(m_dirty.begin() + m_uiFirstDirty, m_dirty.end(), (unsigned char)0);
+	}
+
+	m_uiFirstDirty = nodeCount;
+	return updated;
+}
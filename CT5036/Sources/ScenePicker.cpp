@@ -0,0 +1,149 @@
+//////////////////////////////
+// File: ScenePicker.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "ScenePicker.h" // File's header.
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include "FrustumCuller.h"
+#include "InstanceBuffer.h"
+#include "MeshBVH.h"
+#include "OBJLoader.h"
+
+ScenePicker::ScenePicker(const FrustumCuller* a_pFrustumCuller,
+	const InstanceBuffer* a_pInstanceBuffer) : m_pFrustumCuller(a_pFrustumCuller),
+	m_pInstanceBuffer(a_pInstanceBuffer),
+	m_meshes()
+{}
+
+ScenePicker::~ScenePicker()
+{
+	for (auto iterator = m_meshes.begin(); iterator != m_meshes.end(); ++iterator)
+	{
+		delete iterator->pBVH;
+		iterator->pBVH = nullptr;
+	}
+}
+
+// Registers the mesh drawn with a geometry handle.
+void ScenePicker::AddMesh(unsigned int a_geometryHandle,
+	OBJMesh* a_pMesh,
+	OBJModel* a_pModel,
+	unsigned int a_meshIndex)
+{
+	if (a_geometryHandle >= m_meshes.size())
+	{
+		Mesh empty = { nullptr, nullptr, 0, nullptr };
+		m_meshes.resize(a_geometryHandle + 1, empty);
+	}
+
+	Mesh& mesh = m_meshes[a_geometryHandle];
+	mesh.pMesh = a_pMesh;
+	mesh.pModel = a_pModel;
+	mesh.meshIndex = a_meshIndex;
+	delete mesh.pBVH;
+	mesh.pBVH = nullptr;
+}
+
+// Makes a world space ray through a window position, measured in pixels 
+// from the top left. The ray starts on the near plane and its direction is 
+// normalized.
+void ScenePicker::ScreenToRay(float a_x,
+	float a_y,
+	float a_width,
+	float a_height,
+	const glm::mat4& a_projectionViewMatrix,
+	glm::vec3& a_origin,
+	glm::vec3& a_direction)
+{
+	// Window rows run down the screen, normalized device coordinates run up.
+	const float ndcX = 2.f * a_x / a_width - 1.f;
+	const float ndcY = 1.f - 2.f * a_y / a_height;
+	const glm::mat4 inverse = glm::inverse(a_projectionViewMatrix);
+	const glm::vec4 nearPoint = inverse * glm::vec4(ndcX, ndcY, -1.f, 1.f);
+	const glm::vec4 farPoint = inverse * glm::vec4(ndcX, ndcY, 1.f, 1.f);
+	a_origin = glm::vec3(nearPoint) / nearPoint.w;
+	a_direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - a_origin);
+}
+
+// Finds the closest triangle a normalized world space ray hits within the 
+// maximum distance.
+bool ScenePicker::Raycast(const glm::vec3& a_origin,
+	const glm::vec3& a_direction,
+	float a_maxDistance,
+	Hit& a_hit)
+{
+	std::vector<FrustumCuller::RayCandidate> candidates;
+	m_pFrustumCuller->QueryRay(a_origin, a_direction, a_maxDistance, candidates);
+	bool bHit = false;
+	a_hit.distance = a_maxDistance;
+
+	for (auto iterator = candidates.begin(); iterator != candidates.end(); ++iterator)
+	{
+		// Candidates are nearest first, so none of the rest can be closer.
+		if (iterator->distance > a_hit.distance)
+		{
+			break;
+		}
+
+		if (iterator->geometryHandle >= m_meshes.size() || !m_meshes[iterator->geometryHandle].pMesh)
+		{
+			continue;
+		}
+
+		Mesh& mesh = m_meshes[iterator->geometryHandle];
+
+		if (!mesh.pBVH)
+		{
+			const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			mesh.pBVH = new MeshBVH();
+			mesh.pBVH->Build(mesh.pMesh);
+			const std::chrono::duration<double> buildTime = std::chrono::high_resolution_clock::now() - start;
+			std::cout << "Built triangle BVH for " << mesh.pMesh->GetName() << ": " <<
+				mesh.pBVH->GetTriangleCount() << " triangles, " <<
+				mesh.pBVH->GetNodeCount() << " nodes in " <<
+				buildTime.count() * 1000.0 << "ms.\n";
+		}
+
+		// The direction isn't renormalized in model space, so distances 
+		// along it still match world space ones.
+		const glm::mat4& transform = m_pInstanceBuffer->GetTransform(iterator->instance);
+		const glm::mat4 inverse = glm::inverse(transform);
+		const glm::vec3 origin = glm::vec3(inverse * glm::vec4(a_origin, 1.f));
+		const glm::vec3 direction = glm::vec3(inverse * glm::vec4(a_direction, 0.f));
+		MeshBVH::Hit meshHit;
+
+		if (!mesh.pBVH->Raycast(origin, direction, a_hit.distance, meshHit))
+		{
+			continue;
+		}
+
+		bHit = true;
+		a_hit.pModel = mesh.pModel;
+		a_hit.mesh = mesh.meshIndex;
+		a_hit.triangle = meshHit.triangle;
+		a_hit.instance = iterator->instance;
+		a_hit.barycentrics = glm::vec3(1.f - meshHit.u - meshHit.v, meshHit.u, meshHit.v);
+		a_hit.position = a_origin + a_direction * meshHit.distance;
+		a_hit.distance = meshHit.distance;
+	}
+
+	return bHit;
+}
+
+// Finds the closest triangle under a window position.
+bool ScenePicker::Pick(float a_x,
+	float a_y,
+	float a_width,
+	float a_height,
+	const glm::mat4& a_projectionViewMatrix,
+	Hit& a_hit)
+{
+	glm::vec3 origin(0.f);
+	glm::vec3 direction(0.f);
+	ScreenToRay(a_x, a_y, a_width, a_height, a_projectionViewMatrix, origin, direction);
+	return Raycast(origin, direction, std::numeric_limits<float>::max(), a_hit);
+}
@@ -0,0 +1,101 @@
+//////////////////////////////
+// File: ShaderConstants.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "ShaderConstants.h" // File's header.
+#include <iostream>
+
+ShaderConstants::ShaderConstants() : m_bUploaded(false),
+	m_uiFrameBuffer(0),
+	m_uiMaterialBuffer(0),
+	m_materials()
+{}
+
+ShaderConstants::~ShaderConstants()
+{
+	const GLsizei toDelete = 1;
+	glDeleteBuffers(toDelete, &m_uiFrameBuffer);
+	glDeleteBuffers(toDelete, &m_uiMaterialBuffer);
+}
+
+// Queues a material for the table and returns its index. Materials can only 
+// be added before Upload is called. Textures are texture manager handles for 
+// the diffuse, specular and normal maps, 0 for none, each with a UV scale and 
+// offset into its atlas. Null transforms sample whole textures.
+unsigned int ShaderConstants::AddMaterial(const glm::vec4& a_kA,
+	const glm::vec4& a_kD,
+	const glm::vec4& a_kS,
+	const glm::uvec4& a_textures,
+	const glm::vec4* a_pUVTransforms)
+{
+	if (m_bUploaded)
+	{
+		std::cout << "Error: Materials can't be added after uploading the material table." << std::endl;
+		return 0;
+	}
+
+	MaterialConstants material = { a_kA, a_kD, a_kS, a_textures, {} };
+
+	for (unsigned int i = 0; i < OBJMaterial::TEXTURE_TYPES_COUNT; ++i)
+	{
+		material.uvTransforms[i] = a_pUVTransforms != nullptr ? a_pUVTransforms[i] : glm::vec4(1.f, 1.f, 0.f, 0.f);
+	}
+
+	m_materials.push_back(material);
+	return (unsigned int)m_materials.size() - 1;
+}
+
+// Creates the buffers and copies the material table into its buffer.
+bool ShaderConstants::Upload()
+{
+	if (m_bUploaded)
+	{
+		return false;
+	}
+
+	// Storage buffers can't be empty.
+	if (m_materials.empty())
+	{
+		AddMaterial(glm::vec4(0.f), glm::vec4(0.f), glm::vec4(0.f));
+	}
+
+	const GLsizei toGenerate = 1;
+	glGenBuffers(toGenerate, &m_uiFrameBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_uiFrameBuffer);
+	glBufferStorage(GL_UNIFORM_BUFFER, sizeof(FrameConstants), nullptr, GL_DYNAMIC_STORAGE_BIT);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glGenBuffers(toGenerate, &m_uiMaterialBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiMaterialBuffer);
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER,
+		m_materials.size() * sizeof(MaterialConstants),
+		m_materials.data(),
+		0);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	m_bUploaded = true;
+	std::cout << "Material table: " << m_materials.size() << " materials." << std::endl;
+	return true;
+}
+
+// Writes this frame's camera data.
+void ShaderConstants::UpdateFrame(const glm::mat4& a_projectionViewMatrix,
+	const glm::vec4& a_cameraPosition)
+{
+	FrameConstants frame = { a_projectionViewMatrix, a_cameraPosition };
+	glBindBuffer(GL_UNIFORM_BUFFER, m_uiFrameBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameConstants), &frame);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Binds both buffers to their binding points.
+void ShaderConstants::Bind() const
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, BINDINGS_FRAME, m_uiFrameBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDINGS_MATERIALS, m_uiMaterialBuffer);
+}
+
+unsigned int ShaderConstants::GetMaterialCount() const
+{
+	return (unsigned int)m_materials.size();
+}
@@ -17,6 +17,17 @@
 
 // Static instance of shader uilities.
 ShaderUtilities* ShaderUtilities::m_poInstance = nullptr;
+const char* const ShaderUtilities::ms_uniformNames[UNIFORMS_COUNT] =
+{
+	"drawOffset",
+	"diffuseTexture",
+	"specularTexture",
+	"normalTexture",
+	"bindlessTextures",
+	"view",
+	"projection",
+	"skybox"
+};
 
 ShaderUtilities::ShaderUtilities()
 {}
@@ -188,6 +199,7 @@ unsigned int ShaderUtilities::CreateProgramInternal(const int& a_vertexShader, c
 
 	// Add the program to the shader program vector.
 	m_programs.push_back(handle);
+	ReflectUniforms(handle);
 	// Return the program ID.
 	return handle;
 }
@@ -204,8 +216,104 @@ void ShaderUtilities::DeleteProgramInternal(unsigned int a_program)
 		iterator != m_programs.end();
 		++iterator)
 	{
-		glDeleteProgram(*iterator);
-		m_programs.erase(iterator);
-		break;
+		if (*iterator == a_program)
+		{
+			glDeleteProgram(*iterator);
+			m_programs.erase(iterator);
+			m_programUniforms.erase(a_program);
+			break;
+		}
 	}
+}
+
+int ShaderUtilities::GetUniformLocation(unsigned int a_program,
+	UNIFORMS a_uniform)
+{
+	return ShaderUtilities::GetInstance()->GetUniformLocationInternal(a_program, a_uniform);
+}
+
+int ShaderUtilities::GetUniformLocation(unsigned int a_program,
+	const char* a_name)
+{
+	return ShaderUtilities::GetInstance()->GetUniformLocationInternal(a_program, a_name);
+}
+
+// Reads the program's active uniforms into m_programUniforms.
+void ShaderUtilities::ReflectUniforms(unsigned int a_program)
+{
+	ProgramUniforms& uniforms = m_programUniforms[a_program];
+	uniforms.locationsByName.clear();
+	int uniformCount = 0;
+	int maxNameLength = 0;
+	glGetProgramiv(a_program, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(a_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	std::vector<char> name(maxNameLength + 1);
+
+	for (int i = 0; i < uniformCount; ++i)
+	{
+		GLsizei nameLength = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(a_program,
+			(GLuint)i,
+			(GLsizei)name.size(),
+			&nameLength,
+			&size,
+			&type,
+			name.data());
+		std::string uniformName(name.data(), nameLength);
+		int location = glGetUniformLocation(a_program, uniformName.c_str());
+
+		// Uniform block members don't have a location of their own.
+		if (location < 0)
+		{
+			continue;
+		}
+
+		// Arrays are reported as "name[0]", store them by their plain name.
+		if (uniformName.size() > 3 &&
+			uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+		{
+			uniformName.erase(uniformName.size() - 3);
+		}
+
+		uniforms.locationsByName[uniformName] = location;
+	}
+
+	for (unsigned int i = 0; i < UNIFORMS_COUNT; ++i)
+	{
+		auto iterator = uniforms.locationsByName.find(ms_uniformNames[i]);
+		uniforms.locations[i] = iterator != uniforms.locationsByName.end() ?
+			iterator->second :
+			-1;
+	}
+}
+
+int ShaderUtilities::GetUniformLocationInternal(unsigned int a_program,
+	UNIFORMS a_uniform) const
+{
+	auto iterator = m_programUniforms.find(a_program);
+
+	if (iterator == m_programUniforms.end())
+	{
+		return -1;
+	}
+
+	return iterator->second.locations[a_uniform];
+}
+
+int ShaderUtilities::GetUniformLocationInternal(unsigned int a_program,
+	const char* a_name) const
+{
+	auto programIterator = m_programUniforms.find(a_program);
+
+	if (programIterator == m_programUniforms.end())
+	{
+		return -1;
+	}
+
+	auto iterator = programIterator->second.locationsByName.find(a_name);
+	return iterator != programIterator->second.locationsByName.end() ?
+		iterator->second :
+		-1;
 }
\ No newline at end of file
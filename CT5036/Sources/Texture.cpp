@@ -5,8 +5,8 @@
 //////////////////////////////
 
 #include "Texture.h" // File's header.
+#include <algorithm>
 #include <iostream>
-#define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #ifdef WIN64
 #include "GLAD/glad.h"
@@ -16,9 +16,35 @@
 #include <nn/gll.h>
 #endif
 
+// S3TC is part of every desktop and Switch driver but not core GL, so GLAD 
+// doesn't define it.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif // !GL_COMPRESSED_RGB_S3TC_DXT1_EXT.
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif // !GL_COMPRESSED_RGBA_S3TC_DXT5_EXT.
+
+// GL internal formats of TextureCache::FORMATS.
+static const GLenum sc_internalFormats[TextureCache::FORMATS_COUNT] =
+{
+	GL_RGBA8,
+	GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+	GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	GL_COMPRESSED_RG_RGTC2
+};
+
 Texture::Texture() : m_uiWidth(0),
 	m_uiHeight(0),
+	m_uiLevelCount(0),
+	m_uiBaseLevel(0),
+	m_uiPendingBaseLevel(0),
 	m_uiTextureID(0),
+	m_uiPendingID(0),
+	m_uiStorageVersion(0),
+	m_size(0),
+	m_pendingSize(0),
+	m_format(TextureCache::FORMATS_RGBA8),
 	m_filename()
 {}
 
@@ -41,29 +67,9 @@ bool Texture::Load(std::string a_filename)
 
 	if (imageData != nullptr)
 	{
-		m_uiWidth = width;
-		m_uiHeight = height;
 		m_filename = a_filename;
-		const GLsizei namesToGenerate = 1;
-		glGenTextures(namesToGenerate, &m_uiTextureID);
-		glBindTexture(GL_TEXTURE_2D, m_uiTextureID);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D,
-			GL_TEXTURE_MIN_FILTER,
-			GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexImage2D(GL_TEXTURE_2D,
-			0,
-			GL_RGBA,
-			width,
-			height,
-			0,
-			GL_RGBA,
-			GL_UNSIGNED_BYTE,
-			imageData);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		m_uiTextureID = CreateName();
+		Upload(imageData, width, height);
 		stbi_image_free(imageData);
 		std::cout << "Successfully loaded image file: " << a_filename << std::endl;
 		return true;
@@ -73,9 +79,246 @@ bool Texture::Load(std::string a_filename)
 	return false;
 }
 
+// Creates the texture with a single white texel, drawn in place of textures 
+// that aren't resident.
+void Texture::LoadPlaceholder()
+{
+	m_uiTextureID = CreateName();
+	const unsigned char whiteTexel[4] = { 255, 255, 255, 255 };
+	Upload(whiteTexel, 1, 1);
+}
+
+// Replaces the texture's image with RGBA pixels and generates its mips.
+void Texture::Upload(const unsigned char* a_pPixels, unsigned int a_width, unsigned int a_height)
+{
+	m_uiWidth = a_width;
+	m_uiHeight = a_height;
+	glBindTexture(GL_TEXTURE_2D, m_uiTextureID);
+	glTexImage2D(GL_TEXTURE_2D,
+		0,
+		GL_RGBA,
+		a_width,
+		a_height,
+		0,
+		GL_RGBA,
+		GL_UNSIGNED_BYTE,
+		a_pPixels);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	m_uiLevelCount = 1;
+
+	while ((a_width | a_height) >> m_uiLevelCount)
+	{
+		++m_uiLevelCount;
+	}
+
+	m_size = GetLevelsSize(0, m_uiLevelCount);
+}
+
+// Creates immutable storage for the mips from the first level down under a 
+// pending name. Levels the current name already holds are copied across on 
+// the GPU, the returned level is where they start and the levels above it 
+// must be uploaded. The current name is still drawn until Commit.
+unsigned int Texture::Allocate(unsigned int a_width,
+	unsigned int a_height,
+	unsigned int a_levelCount,
+	TextureCache::FORMATS a_format,
+	unsigned int a_firstLevel)
+{
+	// Immutable storage can't be resized, so a restarted upload starts over 
+	// with a new name.
+	glDeleteTextures(1, &m_uiPendingID);
+	const bool bSameImage = m_uiTextureID != 0 &&
+		a_width == m_uiWidth &&
+		a_height == m_uiHeight &&
+		a_levelCount == m_uiLevelCount &&
+		a_format == m_format;
+	m_uiWidth = a_width;
+	m_uiHeight = a_height;
+	m_uiLevelCount = a_levelCount;
+	m_format = a_format;
+	m_uiPendingBaseLevel = a_firstLevel;
+	m_uiPendingID = CreateName();
+	m_pendingSize = GetLevelsSize(a_firstLevel, a_levelCount);
+	glBindTexture(GL_TEXTURE_2D, m_uiPendingID);
+	glTexStorage2D(GL_TEXTURE_2D,
+		a_levelCount - a_firstLevel,
+		sc_internalFormats[a_format],
+		std::max(a_width >> a_firstLevel, 1u),
+		std::max(a_height >> a_firstLevel, 1u));
+	glBindTexture(GL_TEXTURE_2D, 0);
+	unsigned int uploadEnd = a_levelCount;
+
+	// Resident levels never need reading again, whole levels can be copied 
+	// whatever their block alignment.
+	if (bSameImage)
+	{
+		uploadEnd = std::max(a_firstLevel, m_uiBaseLevel);
+
+		for (unsigned int level = uploadEnd; level < a_levelCount; ++level)
+		{
+			glCopyImageSubData(m_uiTextureID, GL_TEXTURE_2D, level - m_uiBaseLevel, 0, 0, 0,
+				m_uiPendingID, GL_TEXTURE_2D, level - a_firstLevel, 0, 0, 0,
+				std::max(a_width >> level, 1u),
+				std::max(a_height >> level, 1u),
+				1);
+		}
+	}
+
+	// Compressed textures can't be cleared, their levels are undefined 
+	// until uploaded.
+	if (a_format == TextureCache::FORMATS_RGBA8)
+	{
+		const unsigned char whiteTexel[4] = { 255, 255, 255, 255 };
+
+		for (unsigned int level = a_firstLevel; level < uploadEnd; ++level)
+		{
+			glClearTexImage(m_uiPendingID, level - a_firstLevel, GL_RGBA, GL_UNSIGNED_BYTE, whiteTexel);
+		}
+	}
+
+	return uploadEnd;
+}
+
+// Copies rows of texels into a pending mip, compressed rows must start on a 
+// block. Levels are numbered from the full image's. With a pixel unpack 
+// buffer bound the data is an offset into it.
+void Texture::UploadRows(unsigned int a_level,
+	unsigned int a_firstRow,
+	unsigned int a_rowCount,
+	const void* a_pData,
+	unsigned int a_size)
+{
+	const GLsizei levelWidth = m_uiWidth >> a_level > 0 ? m_uiWidth >> a_level : 1;
+	glBindTexture(GL_TEXTURE_2D, m_uiPendingID);
+
+	if (m_format == TextureCache::FORMATS_RGBA8)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D,
+			a_level - m_uiPendingBaseLevel,
+			0,
+			a_firstRow,
+			levelWidth,
+			a_rowCount,
+			GL_RGBA,
+			GL_UNSIGNED_BYTE,
+			a_pData);
+	}
+	else
+	{
+		glCompressedTexSubImage2D(GL_TEXTURE_2D,
+			a_level - m_uiPendingBaseLevel,
+			0,
+			a_firstRow,
+			levelWidth,
+			a_rowCount,
+			sc_internalFormats[m_format],
+			a_size,
+			a_pData);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Replaces the current name with the fully uploaded pending one.
+void Texture::Commit()
+{
+	glDeleteTextures(1, &m_uiTextureID);
+	m_uiTextureID = m_uiPendingID;
+	++m_uiStorageVersion;
+	m_uiPendingID = 0;
+	m_uiBaseLevel = m_uiPendingBaseLevel;
+	m_size = m_pendingSize;
+	m_pendingSize = 0;
+}
+
+// Drops the largest resident mip by copying the rest into smaller storage, 
+// failing when only one level is left.
+bool Texture::Demote()
+{
+	if (m_uiTextureID == 0 || m_uiBaseLevel + 1 >= m_uiLevelCount)
+	{
+		return false;
+	}
+
+	const unsigned int baseLevel = m_uiBaseLevel + 1;
+	const unsigned int levelCount = m_uiLevelCount - baseLevel;
+	const GLuint demotedID = CreateName();
+	glBindTexture(GL_TEXTURE_2D, demotedID);
+	glTexStorage2D(GL_TEXTURE_2D,
+		levelCount,
+		sc_internalFormats[m_format],
+		std::max(m_uiWidth >> baseLevel, 1u),
+		std::max(m_uiHeight >> baseLevel, 1u));
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// The copy stays on the GPU, whole levels can be copied whatever their 
+	// block alignment.
+	for (unsigned int level = 0; level < levelCount; ++level)
+	{
+		glCopyImageSubData(m_uiTextureID, GL_TEXTURE_2D, level + 1, 0, 0, 0,
+			demotedID, GL_TEXTURE_2D, level, 0, 0, 0,
+			std::max(m_uiWidth >> (baseLevel + level), 1u),
+			std::max(m_uiHeight >> (baseLevel + level), 1u),
+			1);
+	}
+
+	glDeleteTextures(1, &m_uiTextureID);
+	m_uiTextureID = demotedID;
+	++m_uiStorageVersion;
+	m_uiBaseLevel = baseLevel;
+	m_size = GetLevelsSize(baseLevel, m_uiLevelCount);
+	return true;
+}
+
+// Frees every mip, the texture must be streamed in again to be drawn.
+void Texture::Evict()
+{
+	Unload();
+	m_uiBaseLevel = 0;
+	m_size = 0;
+	m_pendingSize = 0;
+}
+
 void Texture::Unload()
 {
 	glDeleteTextures(1, &m_uiTextureID);
+	glDeleteTextures(1, &m_uiPendingID);
+	m_uiTextureID = 0;
+	++m_uiStorageVersion;
+	m_uiPendingID = 0;
+}
+
+// Generates a texture name and sets its sampling state.
+unsigned int Texture::CreateName() const
+{
+	const GLsizei namesToGenerate = 1;
+	GLuint textureID = 0;
+	glGenTextures(namesToGenerate, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D,
+		GL_TEXTURE_MIN_FILTER,
+		GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return textureID;
+}
+
+// Bytes in the full image's levels from the first up to the end.
+size_t Texture::GetLevelsSize(unsigned int a_firstLevel, unsigned int a_endLevel) const
+{
+	size_t size = 0;
+
+	for (unsigned int level = a_firstLevel; level < a_endLevel; ++level)
+	{
+		size += TextureCache::GetImageSize(m_format,
+			std::max(m_uiWidth >> level, 1u),
+			std::max(m_uiHeight >> level, 1u));
+	}
+
+	return size;
 }
 
 void Texture::SetFilename(const char* a_pFilename)
@@ -94,7 +337,38 @@ const std::string& Texture::GetFileName() const
 	return m_filename;
 }
 
+// 0 when nothing is resident.
 unsigned int Texture::GetTextureID() const
 {
 	return m_uiTextureID;
+}
+
+// Mips of the full image, 0 until the first Allocate.
+unsigned int Texture::GetLevelCount() const
+{
+	return m_uiLevelCount;
+}
+
+// Largest resident mip, 0 when the full image is resident.
+unsigned int Texture::GetBaseLevel() const
+{
+	return m_uiBaseLevel;
+}
+
+// GL internal format of the resident mips.
+unsigned int Texture::GetInternalFormat() const
+{
+	return sc_internalFormats[m_format];
+}
+
+// Changes whenever the current name's storage is replaced.
+unsigned int Texture::GetStorageVersion() const
+{
+	return m_uiStorageVersion;
+}
+
+// GPU bytes held by the current and pending names.
+size_t Texture::GetSize() const
+{
+	return m_size + m_pendingSize;
 }
\ No newline at end of file
@@ -0,0 +1,440 @@
+//////////////////////////////
+// File: TextureAtlas.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "TextureAtlas.h" // File's header.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stb_image.h>
+#include "TextureCache.h"
+
+const unsigned int TextureAtlas::ms_uiMaxMemberSize = 512;
+const unsigned int TextureAtlas::ms_uiBorder = 16;
+const unsigned int TextureAtlas::ms_uiAlignment = 16;
+const unsigned int TextureAtlas::ms_uiMaxSize = 4096;
+const unsigned int TextureAtlas::ms_uiLevelCount = 3;
+
+// Names of each OBJMaterial::TEXTURE_TYPES atlas.
+static const char* const sc_atlasTypeNames[OBJMaterial::TEXTURE_TYPES_COUNT] =
+{
+	"diffuse",
+	"specular",
+	"normal"
+};
+
+TextureAtlas::TextureAtlas() : m_uiWidth(0),
+	m_uiHeight(0),
+	m_regions()
+{}
+
+TextureAtlas::~TextureAtlas()
+{}
+
+// Packs the files small enough to share an atlas, returning how many were 
+// packed. Others are left out, as are all of them when fewer than two fit.
+unsigned int TextureAtlas::Pack(const std::vector<std::string>& a_filenames)
+{
+	m_uiWidth = 0;
+	m_uiHeight = 0;
+	m_regions.clear();
+	std::vector<Region> regions;
+
+	for (auto iterator = a_filenames.begin(); iterator != a_filenames.end(); ++iterator)
+	{
+		// Only the header is read to size the member.
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		Region region = { *iterator, 0, 0, 0, 0, 0, 0 };
+
+		if (!stbi_info(iterator->c_str(), &width, &height, &channels) ||
+			width <= 0 ||
+			height <= 0 ||
+			(unsigned int)std::max(width, height) > ms_uiMaxMemberSize ||
+			width % ms_uiAlignment != 0 ||
+			height % ms_uiAlignment != 0 ||
+			!OBJMappedFile::GetFileStamp(iterator->c_str(), region.sourceSize, region.sourceModifiedTime))
+		{
+			continue;
+		}
+
+		region.width = width;
+		region.height = height;
+		regions.push_back(region);
+	}
+
+	if (regions.size() < 2)
+	{
+		return 0;
+	}
+
+	// Tallest first keeps the skyline flat, names break ties so the same 
+	// files always pack the same way.
+	std::sort(regions.begin(), regions.end(), [](const Region& a_lhs, const Region& a_rhs)
+	{
+		if (a_lhs.height != a_rhs.height)
+		{
+			return a_lhs.height > a_rhs.height;
+		}
+
+		if (a_lhs.width != a_rhs.width)
+		{
+			return a_lhs.width > a_rhs.width;
+		}
+
+		return a_lhs.filename < a_rhs.filename;
+	});
+
+	unsigned int widestCell = 0;
+
+	for (auto iterator = regions.begin(); iterator != regions.end(); ++iterator)
+	{
+		widestCell = std::max(widestCell, iterator->width + 2 * ms_uiBorder);
+	}
+
+	// Every width the cells fit is tried, keeping the one with the least 
+	// area, then the squarest.
+	size_t bestArea = std::numeric_limits<size_t>::max();
+
+	for (unsigned int width = widestCell; width <= ms_uiMaxSize; width += ms_uiAlignment)
+	{
+		std::vector<Region> packed = regions;
+		const unsigned int height = PackCells(width, packed);
+		const size_t area = (size_t)width * height;
+
+		if (height == 0 ||
+			area > bestArea ||
+			(area == bestArea && std::max(width, height) >= std::max(m_uiWidth, m_uiHeight)))
+		{
+			continue;
+		}
+
+		bestArea = area;
+		m_uiWidth = width;
+		m_uiHeight = height;
+		m_regions.swap(packed);
+	}
+
+	return (unsigned int)m_regions.size();
+}
+
+// Writes the manifest, leaving the file alone when it's unchanged so its 
+// cache stays valid.
+bool TextureAtlas::Save(const char* a_pFilename) const
+{
+	const std::string manifest = GetManifest();
+	std::ifstream existingFile(a_pFilename, std::ios_base::in | std::ios_base::binary);
+
+	if (existingFile.is_open())
+	{
+		std::stringstream existing;
+		existing << existingFile.rdbuf();
+
+		if (existing.str() == manifest)
+		{
+			return true;
+		}
+
+		existingFile.close();
+	}
+
+	std::ofstream file(a_pFilename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << manifest;
+	return file.good();
+}
+
+bool TextureAtlas::Load(const char* a_pFilename)
+{
+	m_uiWidth = 0;
+	m_uiHeight = 0;
+	m_regions.clear();
+	std::ifstream file(a_pFilename, std::ios_base::in | std::ios_base::binary);
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		std::istringstream values(line);
+		std::string tag;
+		values >> tag;
+
+		if (tag == "atlas")
+		{
+			values >> m_uiWidth >> m_uiHeight;
+		}
+		else if (tag == "region")
+		{
+			Region region;
+			values >> region.x >> region.y >> region.width >> region.height >>
+				region.sourceSize >> region.sourceModifiedTime;
+			// The filename is the rest of the line, it may hold spaces.
+			values >> std::ws;
+			std::getline(values, region.filename);
+
+			if (values.fail() || region.filename.empty())
+			{
+				m_regions.clear();
+				return false;
+			}
+
+			m_regions.push_back(region);
+		}
+	}
+
+	return m_uiWidth > 0 && m_uiHeight > 0 && !m_regions.empty();
+}
+
+// Builds the atlas's levels from its members' mips.
+bool TextureAtlas::Compose(TextureCache& a_cache) const
+{
+	if (m_regions.empty())
+	{
+		return false;
+	}
+
+	a_cache.Create(m_uiWidth, m_uiHeight, ms_uiLevelCount);
+
+	// Space between cells is opaque, so atlases of opaque members still 
+	// compress without alpha.
+	for (unsigned int level = 0; level < ms_uiLevelCount; ++level)
+	{
+		unsigned char* pAtlas = a_cache.GetBuiltLevel(level);
+		const size_t texelCount = (size_t)a_cache.GetLevelWidth(level) * a_cache.GetLevelHeight(level);
+
+		for (size_t texel = 0; texel < texelCount; ++texel)
+		{
+			pAtlas[texel * 4 + 3] = 255;
+		}
+	}
+
+	for (auto region = m_regions.begin(); region != m_regions.end(); ++region)
+	{
+		TextureCache member;
+
+		if (!member.Decode(region->filename.c_str()) ||
+			member.GetWidth() != region->width ||
+			member.GetHeight() != region->height)
+		{
+			return false;
+		}
+
+		// Each level is copied from the member's own mip rather than 
+		// filtered from the atlas, so neighbours never blend together.
+		for (unsigned int level = 0; level < ms_uiLevelCount; ++level)
+		{
+			const unsigned int width = region->width >> level;
+			const unsigned int height = region->height >> level;
+			const unsigned int border = ms_uiBorder >> level;
+			const unsigned int x = region->x >> level;
+			const unsigned int y = region->y >> level;
+			const unsigned int atlasWidth = a_cache.GetLevelWidth(level);
+			const unsigned char* pMember = member.GetLevel(level);
+			unsigned char* pAtlas = a_cache.GetBuiltLevel(level);
+
+			// The border wraps around to the member's opposite edges, as 
+			// the member would repeat on its own.
+			for (unsigned int row = 0; row < height + 2 * border; ++row)
+			{
+				const unsigned char* pMemberRow = pMember + (size_t)((row + height - border) % height) * width * 4;
+				unsigned char* pAtlasRow = pAtlas + ((size_t)(y - border + row) * atlasWidth + x - border) * 4;
+
+				for (unsigned int column = 0; column < width + 2 * border; ++column)
+				{
+					memcpy(pAtlasRow + column * 4, pMemberRow + ((column + width - border) % width) * 4, 4);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// Null when the file isn't packed in the atlas.
+const TextureAtlas::Region* TextureAtlas::FindRegion(const std::string& a_filename) const
+{
+	for (auto iterator = m_regions.begin(); iterator != m_regions.end(); ++iterator)
+	{
+		if (iterator->filename == a_filename)
+		{
+			return &*iterator;
+		}
+	}
+
+	return nullptr;
+}
+
+// Scale in XY and offset in ZW from a member's UVs to the atlas's.
+glm::vec4 TextureAtlas::GetUVTransform(const Region& a_region) const
+{
+	return glm::vec4((float)a_region.width / m_uiWidth,
+		(float)a_region.height / m_uiHeight,
+		(float)a_region.x / m_uiWidth,
+		(float)a_region.y / m_uiHeight);
+}
+
+unsigned int TextureAtlas::GetRegionCount() const
+{
+	return (unsigned int)m_regions.size();
+}
+
+unsigned int TextureAtlas::GetWidth() const
+{
+	return m_uiWidth;
+}
+
+unsigned int TextureAtlas::GetHeight() const
+{
+	return m_uiHeight;
+}
+
+bool TextureAtlas::IsAtlas(const char* a_pFilename)
+{
+	const char extension[] = ".atlas";
+	const size_t extensionLength = sizeof(extension) - 1;
+	const size_t length = strlen(a_pFilename);
+	return length >= extensionLength && strcmp(a_pFilename + length - extensionLength, extension) == 0;
+}
+
+// Manifest of the atlas holding a model's textures of one type.
+std::string TextureAtlas::GetAtlasFileName(const char* a_pModelFilename, OBJMaterial::TEXTURE_TYPES a_type)
+{
+	return std::string(a_pModelFilename) + "." + sc_atlasTypeNames[a_type] + ".atlas";
+}
+
+// Every texture of one type the model's materials use, once each.
+void TextureAtlas::GetModelTextures(OBJModel* a_pModel,
+	OBJMaterial::TEXTURE_TYPES a_type,
+	std::vector<std::string>& a_filenames)
+{
+	a_filenames.clear();
+
+	for (unsigned int i = 0; i < a_pModel->GetMaterialCount(); ++i)
+	{
+		const std::string filename = a_pModel->GetMaterialByIndex(i)->GetTextureFileName(a_type);
+
+		if (!filename.empty() && std::find(a_filenames.begin(), a_filenames.end(), filename) == a_filenames.end())
+		{
+			a_filenames.push_back(filename);
+		}
+	}
+}
+
+// Packs the cells into the given width, returning the height used or 0 when 
+// it's taller than the largest atlas.
+unsigned int TextureAtlas::PackCells(unsigned int a_width, std::vector<Region>& a_regions) const
+{
+	// Tops of the cells placed so far, left to right across the atlas.
+	std::vector<SkylineSegment> skyline(1, SkylineSegment{ 0, 0, a_width });
+	std::vector<SkylineSegment> placed;
+	unsigned int height = 0;
+
+	for (auto region = a_regions.begin(); region != a_regions.end(); ++region)
+	{
+		const unsigned int cellWidth = region->width + 2 * ms_uiBorder;
+		const unsigned int cellHeight = region->height + 2 * ms_uiBorder;
+		// Each cell goes where its bottom is lowest, leftmost on ties.
+		unsigned int cellX = 0;
+		unsigned int cellY = std::numeric_limits<unsigned int>::max();
+
+		for (unsigned int i = 0; i < skyline.size() && skyline[i].x + cellWidth <= a_width; ++i)
+		{
+			unsigned int y = 0;
+
+			for (unsigned int j = i; j < skyline.size() && skyline[j].x < skyline[i].x + cellWidth; ++j)
+			{
+				y = std::max(y, skyline[j].y);
+			}
+
+			if (y < cellY)
+			{
+				cellX = skyline[i].x;
+				cellY = y;
+			}
+		}
+
+		if (cellY == std::numeric_limits<unsigned int>::max() || cellY + cellHeight > ms_uiMaxSize)
+		{
+			return 0;
+		}
+
+		region->x = cellX + ms_uiBorder;
+		region->y = cellY + ms_uiBorder;
+		height = std::max(height, cellY + cellHeight);
+		// The cell's top replaces the segments it covers, cells always start 
+		// where a segment does.
+		const SkylineSegment top = { cellX, cellY + cellHeight, cellWidth };
+		const unsigned int cellEnd = cellX + cellWidth;
+		bool bTopPlaced = false;
+		placed.clear();
+
+		for (auto segment = skyline.begin(); segment != skyline.end(); ++segment)
+		{
+			const unsigned int segmentEnd = segment->x + segment->width;
+
+			if (segmentEnd <= cellX)
+			{
+				placed.push_back(*segment);
+				continue;
+			}
+
+			if (!bTopPlaced)
+			{
+				placed.push_back(top);
+				bTopPlaced = true;
+			}
+
+			if (segment->x >= cellEnd)
+			{
+				placed.push_back(*segment);
+			}
+			else if (segmentEnd > cellEnd)
+			{
+				placed.push_back(SkylineSegment{ cellEnd, segment->y, segmentEnd - cellEnd });
+			}
+		}
+
+		// Neighbours at the same height are merged into one segment.
+		skyline.clear();
+
+		for (auto segment = placed.begin(); segment != placed.end(); ++segment)
+		{
+			if (!skyline.empty() && skyline.back().y == segment->y)
+			{
+				skyline.back().width += segment->width;
+			}
+			else
+			{
+				skyline.push_back(*segment);
+			}
+		}
+	}
+
+	return height;
+}
+
+// Text written to the manifest.
+std::string TextureAtlas::GetManifest() const
+{
+	std::ostringstream manifest;
+	manifest << "atlas " << m_uiWidth << " " << m_uiHeight << "\n";
+
+	for (auto iterator = m_regions.begin(); iterator != m_regions.end(); ++iterator)
+	{
+		manifest << "region " << iterator->x << " " << iterator->y << " " <<
+			iterator->width << " " << iterator->height << " " <<
+			iterator->sourceSize << " " << iterator->sourceModifiedTime << " " <<
+			iterator->filename << "\n";
+	}
+
+	return manifest.str();
+}
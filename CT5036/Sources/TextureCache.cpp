@@ -0,0 +1,633 @@
+//////////////////////////////
+// File: TextureCache.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "TextureCache.h" // File's header.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "TextureAtlas.h"
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// Binary cache layout. The header is followed by each level, largest first, 
+// with tightly packed rows of texels or blocks. Bump the version whenever the 
+// layout, the mip filter or the encoder changes.
+static const char sc_cacheMagic[4] = { 'T', 'E', 'X', 'C' };
+static const unsigned int sc_cacheVersion = 2;
+// Levels are aligned so they can be copied from in place.
+static const size_t sc_cacheAlignment = 16;
+
+typedef struct TextureCacheHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int width;
+	unsigned int height;
+	unsigned int levelCount;
+	unsigned int format;
+	// The source image the cache was built from.
+	unsigned long long sourceSize;
+	long long sourceModifiedTime;
+	unsigned long long sourceHash;
+	// Total size of the cache, a mismatch means it was only partly written.
+	unsigned long long fileSize;
+} TextureCacheHeader;
+
+static size_t AlignCacheOffset(size_t a_offset)
+{
+	return (a_offset + sc_cacheAlignment - 1) & ~(sc_cacheAlignment - 1);
+}
+
+// A source pixel and how much of it a destination pixel takes.
+typedef struct FilterTap
+{
+	unsigned int source;
+	float weight;
+} FilterTap;
+
+// Weights a triangle filter twice the width of the scale between sizes, so 
+// halving takes 1, 3, 3, 1 eighths of four pixels. Edges wrap, as textures 
+// repeat.
+static void MakeFilterTaps(unsigned int a_sourceSize,
+	unsigned int a_size,
+	std::vector<std::vector<FilterTap>>& a_taps)
+{
+	const float scale = (float)a_sourceSize / a_size;
+	const int reach = (int)ceil(scale);
+	a_taps.assign(a_size, std::vector<FilterTap>());
+
+	for (unsigned int i = 0; i < a_size; ++i)
+	{
+		const float centre = (i + 0.5f) * scale;
+		const int first = (int)floor(centre) - reach;
+		float totalWeight = 0.f;
+
+		for (int source = first; source <= first + reach * 2; ++source)
+		{
+			const float weight = 1.f - fabs(source + 0.5f - centre) / scale;
+
+			if (weight <= 0.f)
+			{
+				continue;
+			}
+
+			const int wrapped = ((source % (int)a_sourceSize) + (int)a_sourceSize) % (int)a_sourceSize;
+			FilterTap tap = { (unsigned int)wrapped, weight };
+			a_taps[i].push_back(tap);
+			totalWeight += weight;
+		}
+
+		for (auto iterator = a_taps[i].begin(); iterator != a_taps[i].end(); ++iterator)
+		{
+			iterator->weight /= totalWeight;
+		}
+	}
+}
+
+// Bytes in each format's 4x4 block, 0 for uncompressed formats.
+static const unsigned int sc_blockSizes[TextureCache::FORMATS_COUNT] = { 0, 8, 16, 16 };
+
+TextureCache::TextureCache() : m_uiWidth(0),
+	m_uiHeight(0),
+	m_format(FORMATS_RGBA8),
+	m_pLevels(nullptr),
+	m_levelOffsets(),
+	m_builtLevels(),
+	m_file(),
+	m_sourceSize(0),
+	m_sourceHash(0)
+{}
+
+TextureCache::~TextureCache()
+{}
+
+// Decodes a source image and builds its mips. Rows run bottom to top, as GL 
+// expects. Atlas manifests are decoded by composing their members.
+bool TextureCache::Decode(const char* a_pSourceFilename)
+{
+	if (TextureAtlas::IsAtlas(a_pSourceFilename))
+	{
+		TextureAtlas atlas;
+		return atlas.Load(a_pSourceFilename) && atlas.Compose(*this);
+	}
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	const int desiredChannels = 4;
+	// The flip setting is per thread, so decoding threads don't race on it.
+	stbi_set_flip_vertically_on_load_thread(true);
+	unsigned char* pPixels = stbi_load(a_pSourceFilename, &width, &height, &channels, desiredChannels);
+
+	if (pPixels == nullptr)
+	{
+		return false;
+	}
+
+	m_file.Close();
+	m_sourceSize = 0;
+	m_sourceHash = 0;
+	m_uiWidth = width;
+	m_uiHeight = height;
+	m_format = FORMATS_RGBA8;
+	unsigned int levelCount = 1;
+
+	while ((m_uiWidth | m_uiHeight) >> levelCount)
+	{
+		++levelCount;
+	}
+
+	const size_t offset = LayOutLevels(levelCount);
+	m_builtLevels.resize(offset);
+	memcpy(m_builtLevels.data(), pPixels, (size_t)m_uiWidth * m_uiHeight * 4);
+	stbi_image_free(pPixels);
+	m_pLevels = m_builtLevels.data();
+	BuildMips();
+	return true;
+}
+
+// Lays out blank RGBA8 levels for an image built on the CPU.
+void TextureCache::Create(unsigned int a_width, unsigned int a_height, unsigned int a_levelCount)
+{
+	m_file.Close();
+	m_sourceSize = 0;
+	m_sourceHash = 0;
+	m_uiWidth = a_width;
+	m_uiHeight = a_height;
+	m_format = FORMATS_RGBA8;
+	m_builtLevels.assign(LayOutLevels(a_levelCount), 0);
+	m_pLevels = m_builtLevels.data();
+}
+
+// Maps a cache, failing if it's missing, its source has changed or it was 
+// compressed for the other kind of map.
+bool TextureCache::Load(const char* a_pCacheFilename, const char* a_pSourceFilename, bool a_bNormalMap)
+{
+	if (!m_file.Open(a_pCacheFilename) || m_file.GetSize() < sizeof(TextureCacheHeader))
+	{
+		m_file.Close();
+		return false;
+	}
+
+	TextureCacheHeader header;
+	memcpy(&header, m_file.GetData(), sizeof(header));
+	unsigned long long sourceSize = 0;
+	long long sourceModifiedTime = 0;
+
+	if (memcmp(header.magic, sc_cacheMagic, sizeof(sc_cacheMagic)) != 0 ||
+		header.version != sc_cacheVersion ||
+		header.fileSize != m_file.GetSize() ||
+		!OBJMappedFile::GetFileStamp(a_pSourceFilename, sourceSize, sourceModifiedTime) ||
+		sourceSize != header.sourceSize)
+	{
+		std::cout << "Texture cache is out of date: " << a_pCacheFilename << std::endl;
+		m_file.Close();
+		return false;
+	}
+
+	// A new timestamp alone doesn't mean the contents changed.
+	if (sourceModifiedTime != header.sourceModifiedTime)
+	{
+		OBJMappedFile sourceData;
+
+		if (!sourceData.Open(a_pSourceFilename) || sourceData.GetHash() != header.sourceHash)
+		{
+			std::cout << "Texture cache is out of date: " << a_pCacheFilename << std::endl;
+			m_file.Close();
+			return false;
+		}
+	}
+
+	if (header.format >= FORMATS_COUNT || (header.format == FORMATS_BC5) != a_bNormalMap)
+	{
+		std::cout << "Texture cache is out of date: " << a_pCacheFilename << std::endl;
+		m_file.Close();
+		return false;
+	}
+
+	// A full mip chain ends at 1x1, more levels than that can only come from 
+	// a corrupt header.
+	unsigned int maxLevelCount = 1;
+
+	while (maxLevelCount < 32 && (header.width | header.height) >> maxLevelCount)
+	{
+		++maxLevelCount;
+	}
+
+	if (header.width == 0 ||
+		header.height == 0 ||
+		header.levelCount == 0 ||
+		header.levelCount > maxLevelCount)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_uiWidth = header.width;
+	m_uiHeight = header.height;
+	m_format = (FORMATS)header.format;
+	const size_t offset = LayOutLevels(header.levelCount);
+	const size_t levelsStart = AlignCacheOffset(sizeof(TextureCacheHeader));
+
+	if (levelsStart + offset != m_file.GetSize())
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_builtLevels.clear();
+	m_pLevels = (const unsigned char*)m_file.GetData() + levelsStart;
+	m_sourceSize = header.sourceSize;
+	m_sourceHash = header.sourceHash;
+	return true;
+}
+
+// Touches the pages of every level from the first down, so copying them 
+// later doesn't stall on reads from disk. Returns the bytes touched.
+size_t TextureCache::Prefetch(unsigned int a_firstLevel) const
+{
+	if (m_pLevels == nullptr || a_firstLevel >= GetLevelCount())
+	{
+		return 0;
+	}
+
+	volatile unsigned char touched = 0;
+	const size_t pageSize = 4096;
+	const size_t start = m_levelOffsets[a_firstLevel];
+
+	for (size_t page = start; page < GetSize(); page += pageSize)
+	{
+		touched += m_pLevels[page];
+	}
+
+	return GetSize() - start;
+}
+
+bool TextureCache::Save(const char* a_pCacheFilename, const char* a_pSourceFilename) const
+{
+	OBJMappedFile sourceData;
+	TextureCacheHeader header;
+	memset(&header, 0, sizeof(header));
+
+	if (m_pLevels == nullptr ||
+		!OBJMappedFile::GetFileStamp(a_pSourceFilename, header.sourceSize, header.sourceModifiedTime) ||
+		!sourceData.Open(a_pSourceFilename))
+	{
+		return false;
+	}
+
+	memcpy(header.magic, sc_cacheMagic, sizeof(sc_cacheMagic));
+	header.version = sc_cacheVersion;
+	header.width = m_uiWidth;
+	header.height = m_uiHeight;
+	header.levelCount = GetLevelCount();
+	header.format = m_format;
+	header.sourceHash = sourceData.GetHash();
+	const size_t levelsStart = AlignCacheOffset(sizeof(TextureCacheHeader));
+	header.fileSize = levelsStart + GetSize();
+	std::fstream file;
+	file.open(a_pCacheFilename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	const char padding[sc_cacheAlignment] = {};
+	file.write((const char*)&header, sizeof(header));
+	file.write(padding, levelsStart - sizeof(header));
+	file.write((const char*)m_pLevels, GetSize());
+	bool success = file.good();
+	file.close();
+
+	if (!success)
+	{
+		remove(a_pCacheFilename);
+	}
+
+	return success;
+}
+
+// Normal maps have their own cache, so an image used as both kinds of map 
+// keeps a cache for each.
+std::string TextureCache::GetCacheFileName(const char* a_pSourceFilename, bool a_bNormalMap)
+{
+	return std::string(a_pSourceFilename) + (a_bNormalMap ? ".normal.cache" : ".cache");
+}
+
+unsigned int TextureCache::GetWidth() const
+{
+	return m_uiWidth;
+}
+
+unsigned int TextureCache::GetHeight() const
+{
+	return m_uiHeight;
+}
+
+unsigned int TextureCache::GetLevelCount() const
+{
+	return m_levelOffsets.empty() ? 0 : (unsigned int)m_levelOffsets.size() - 1;
+}
+
+unsigned int TextureCache::GetLevelWidth(unsigned int a_level) const
+{
+	return std::max(1u, m_uiWidth >> a_level);
+}
+
+unsigned int TextureCache::GetLevelHeight(unsigned int a_level) const
+{
+	return std::max(1u, m_uiHeight >> a_level);
+}
+
+TextureCache::FORMATS TextureCache::GetFormat() const
+{
+	return m_format;
+}
+
+// Largest level no more than the given texels across, 0 for the top.
+unsigned int TextureCache::FindLevel(unsigned int a_maxSize) const
+{
+	unsigned int level = 0;
+
+	while (a_maxSize > 0 && level + 1 < GetLevelCount() &&
+		std::max(GetLevelWidth(level), GetLevelHeight(level)) > a_maxSize)
+	{
+		++level;
+	}
+
+	return level;
+}
+
+// Levels are stored as rows of texels, or rows of 4x4 blocks when 
+// compressed.
+unsigned int TextureCache::GetRowHeight() const
+{
+	return sc_blockSizes[m_format] > 0 ? 4 : 1;
+}
+
+unsigned int TextureCache::GetRowCount(unsigned int a_level) const
+{
+	return (GetLevelHeight(a_level) + GetRowHeight() - 1) / GetRowHeight();
+}
+
+unsigned int TextureCache::GetRowSize(unsigned int a_level) const
+{
+	if (sc_blockSizes[m_format] > 0)
+	{
+		return (GetLevelWidth(a_level) + 3) / 4 * sc_blockSizes[m_format];
+	}
+
+	return GetLevelWidth(a_level) * 4;
+}
+
+const unsigned char* TextureCache::GetLevel(unsigned int a_level) const
+{
+	return m_pLevels + m_levelOffsets[a_level];
+}
+
+// Writable level of an image built by Create.
+unsigned char* TextureCache::GetBuiltLevel(unsigned int a_level)
+{
+	return m_builtLevels.data() + m_levelOffsets[a_level];
+}
+
+// Bytes in every level together.
+size_t TextureCache::GetSize() const
+{
+	return m_levelOffsets.empty() ? 0 : m_levelOffsets.back();
+}
+
+// Size and XXH64 hash of the source a loaded cache was built from, read from 
+// its header so the source isn't read again. 0 for decoded images.
+unsigned long long TextureCache::GetSourceSize() const
+{
+	return m_sourceSize;
+}
+
+unsigned long long TextureCache::GetSourceHash() const
+{
+	return m_sourceHash;
+}
+
+// Bytes in an image of the given format and size.
+size_t TextureCache::GetImageSize(FORMATS a_format, unsigned int a_width, unsigned int a_height)
+{
+	if (sc_blockSizes[a_format] > 0)
+	{
+		return (size_t)((a_width + 3) / 4) * ((a_height + 3) / 4) * sc_blockSizes[a_format];
+	}
+
+	return (size_t)a_width * a_height * 4;
+}
+
+// Block compresses every level, BC5 for normal maps, otherwise BC1 or BC3 
+// when any texel isn't opaque. 0 threads uses every hardware thread.
+void TextureCache::Compress(bool a_bNormalMap, unsigned int a_threadCount)
+{
+	if (m_format != FORMATS_RGBA8 || m_pLevels == nullptr)
+	{
+		return;
+	}
+
+	// The compressed levels replace these, so they're copied first.
+	const std::vector<unsigned char> levels(m_pLevels, m_pLevels + GetSize());
+	const std::vector<size_t> levelOffsets = m_levelOffsets;
+	const unsigned int levelCount = GetLevelCount();
+	bool bOpaque = true;
+
+	for (size_t alpha = 3; alpha < levelOffsets[1] && bOpaque; alpha += 4)
+	{
+		bOpaque = levels[alpha] == 255;
+	}
+
+	m_format = a_bNormalMap ? FORMATS_BC5 : (bOpaque ? FORMATS_BC1 : FORMATS_BC3);
+	m_file.Close();
+	// stb_dxt builds its lookup tables on first use without a lock, so a 
+	// block is compressed once before any thread, here or on other decode 
+	// workers, can reach the encoder.
+	static std::once_flag s_encoderInitialized;
+	std::call_once(s_encoderInitialized, []()
+	{
+		unsigned char block[16 * 4] = {};
+		unsigned char compressed[16] = {};
+		stb_compress_dxt_block(compressed, block, 1, STB_DXT_HIGHQUAL);
+	});
+	m_builtLevels.assign(LayOutLevels(levelCount), 0);
+	m_pLevels = m_builtLevels.data();
+	// Every row of blocks in every level is a job, shared out as threads 
+	// become free.
+	std::vector<std::pair<unsigned int, unsigned int>> jobs;
+
+	for (unsigned int level = 0; level < levelCount; ++level)
+	{
+		for (unsigned int row = 0; row < GetRowCount(level); ++row)
+		{
+			jobs.push_back(std::make_pair(level, row));
+		}
+	}
+
+	std::atomic<unsigned int> nextJob(0);
+
+	auto compressRows = [&]()
+	{
+		unsigned char block[16 * 4];
+		unsigned char channels[16 * 2];
+
+		for (unsigned int job = nextJob++; job < jobs.size(); job = nextJob++)
+		{
+			const unsigned int level = jobs[job].first;
+			const unsigned int row = jobs[job].second;
+			const unsigned int width = GetLevelWidth(level);
+			const unsigned int height = GetLevelHeight(level);
+			const unsigned char* pSource = levels.data() + levelOffsets[level];
+			unsigned char* pDestination = m_builtLevels.data() + m_levelOffsets[level] + (size_t)row * GetRowSize(level);
+
+			for (unsigned int column = 0; column < (width + 3) / 4; ++column)
+			{
+				// Blocks hanging over the level's edge repeat its last texels.
+				for (unsigned int texel = 0; texel < 16; ++texel)
+				{
+					const unsigned int x = std::min(column * 4 + texel % 4, width - 1);
+					const unsigned int y = std::min(row * 4 + texel / 4, height - 1);
+					memcpy(&block[texel * 4], pSource + ((size_t)y * width + x) * 4, 4);
+					channels[texel * 2] = block[texel * 4];
+					channels[texel * 2 + 1] = block[texel * 4 + 1];
+				}
+
+				if (m_format == FORMATS_BC5)
+				{
+					stb_compress_bc5_block(pDestination, channels);
+				}
+				else
+				{
+					stb_compress_dxt_block(pDestination, block, m_format == FORMATS_BC3, STB_DXT_HIGHQUAL);
+				}
+
+				pDestination += sc_blockSizes[m_format];
+			}
+		}
+	};
+
+	unsigned int threadCount = a_threadCount;
+
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// This thread compresses alongside the workers.
+	std::vector<std::thread> workers;
+
+	for (unsigned int i = 1; i < threadCount; ++i)
+	{
+		workers.push_back(std::thread(compressRows));
+	}
+
+	compressRows();
+
+	for (auto iterator = workers.begin(); iterator != workers.end(); ++iterator)
+	{
+		iterator->join();
+	}
+}
+
+// Builds every level below the top one with a triangle filter.
+void TextureCache::BuildMips()
+{
+	std::vector<std::vector<FilterTap>> columnTaps;
+	std::vector<std::vector<FilterTap>> rowTaps;
+	std::vector<float> filteredRows;
+	std::vector<float> filteredRow;
+
+	for (unsigned int level = 1; level < GetLevelCount(); ++level)
+	{
+		const unsigned int sourceWidth = GetLevelWidth(level - 1);
+		const unsigned int sourceHeight = GetLevelHeight(level - 1);
+		const unsigned int width = GetLevelWidth(level);
+		const unsigned int height = GetLevelHeight(level);
+		const unsigned char* pSource = GetLevel(level - 1);
+		unsigned char* pLevel = m_builtLevels.data() + m_levelOffsets[level];
+		MakeFilterTaps(sourceWidth, width, columnTaps);
+		MakeFilterTaps(sourceHeight, height, rowTaps);
+		// Filter across each source row first, then down the columns.
+		filteredRows.resize((size_t)width * sourceHeight * 4);
+
+		for (unsigned int y = 0; y < sourceHeight; ++y)
+		{
+			const unsigned char* pSourceRow = pSource + (size_t)y * sourceWidth * 4;
+			float* pFilteredRow = &filteredRows[(size_t)y * width * 4];
+
+			for (unsigned int x = 0; x < width; ++x)
+			{
+				float red = 0.f;
+				float green = 0.f;
+				float blue = 0.f;
+				float alpha = 0.f;
+
+				for (auto tap = columnTaps[x].begin(); tap != columnTaps[x].end(); ++tap)
+				{
+					const unsigned char* pTexel = pSourceRow + tap->source * 4;
+					red += pTexel[0] * tap->weight;
+					green += pTexel[1] * tap->weight;
+					blue += pTexel[2] * tap->weight;
+					alpha += pTexel[3] * tap->weight;
+				}
+
+				pFilteredRow[x * 4] = red;
+				pFilteredRow[x * 4 + 1] = green;
+				pFilteredRow[x * 4 + 2] = blue;
+				pFilteredRow[x * 4 + 3] = alpha;
+			}
+		}
+
+		for (unsigned int y = 0; y < height; ++y)
+		{
+			// Whole rows are weighted at once, which the compiler vectorizes.
+			filteredRow.assign((size_t)width * 4, 0.f);
+
+			for (auto tap = rowTaps[y].begin(); tap != rowTaps[y].end(); ++tap)
+			{
+				const float* pFilteredRow = &filteredRows[(size_t)tap->source * width * 4];
+
+				for (unsigned int x = 0; x < width * 4; ++x)
+				{
+					filteredRow[x] += pFilteredRow[x] * tap->weight;
+				}
+			}
+
+			unsigned char* pRow = pLevel + (size_t)y * width * 4;
+
+			for (unsigned int x = 0; x < width * 4; ++x)
+			{
+				pRow[x] = (unsigned char)std::min(255.f, filteredRow[x] + 0.5f);
+			}
+		}
+	}
+}
+
+// Lays out every level in the current format, returning the total size.
+size_t TextureCache::LayOutLevels(unsigned int a_levelCount)
+{
+	m_levelOffsets.clear();
+	size_t offset = 0;
+
+	for (unsigned int level = 0; level < a_levelCount; ++level)
+	{
+		m_levelOffsets.push_back(offset);
+		offset = AlignCacheOffset(offset + (size_t)GetRowCount(level) * GetRowSize(level));
+	}
+
+	m_levelOffsets.push_back(offset);
+	return offset;
+}
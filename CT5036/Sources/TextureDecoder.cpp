@@ -0,0 +1,163 @@
+//////////////////////////////
+// File: TextureDecoder.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "TextureDecoder.h" // File's header.
+#include <algorithm>
+#include "TextureCache.h"
+
+// 0 threads uses every hardware thread but the one queueing files.
+TextureDecoder::TextureDecoder(unsigned int a_threadCount) : m_bStopping(false),
+	m_uiDecoding(0),
+	m_workers(),
+	m_mutex(),
+	m_queueChanged(),
+	m_queue(),
+	m_decoded()
+{
+	unsigned int threadCount = a_threadCount;
+
+	if (threadCount == 0)
+	{
+		threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+	}
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		m_workers.push_back(std::thread(&TextureDecoder::Work, this));
+	}
+}
+
+TextureDecoder::~TextureDecoder()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		m_queue.clear();
+	}
+
+	m_queueChanged.notify_all();
+
+	for (auto iterator = m_workers.begin(); iterator != m_workers.end(); ++iterator)
+	{
+		iterator->join();
+	}
+
+	for (auto iterator = m_decoded.begin(); iterator != m_decoded.end(); ++iterator)
+	{
+		delete iterator->pCache;
+	}
+}
+
+// Normal maps are compressed to two channels. Only the levels up to the 
+// largest no more than the maximum size across are read, 0 reads all.
+void TextureDecoder::Queue(const std::string& a_filename, bool a_bNormalMap, unsigned int a_maxSize)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Request request = { a_filename, a_bNormalMap, a_maxSize };
+		m_queue.push_back(request);
+	}
+
+	m_queueChanged.notify_one();
+}
+
+// Moves every image decoded since the last call into the list.
+void TextureDecoder::TakeDecoded(std::vector<Image>& a_images)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	a_images.insert(a_images.end(), m_decoded.begin(), m_decoded.end());
+	m_decoded.clear();
+}
+
+// Files queued, being decoded or decoded but not yet taken.
+unsigned int TextureDecoder::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return (unsigned int)(m_queue.size() + m_decoded.size()) + m_uiDecoding;
+}
+
+unsigned int TextureDecoder::GetThreadCount() const
+{
+	return (unsigned int)m_workers.size();
+}
+
+void TextureDecoder::Work()
+{
+	while (true)
+	{
+		Image image = { std::string(), false, nullptr, false, 0, 0, 0, false };
+		unsigned int maxSize = 0;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_queueChanged.wait(lock, [this]() { return m_bStopping || !m_queue.empty(); });
+
+			if (m_bStopping)
+			{
+				return;
+			}
+
+			image.filename = m_queue.front().filename;
+			image.bNormalMap = m_queue.front().bNormalMap;
+			maxSize = m_queue.front().maxSize;
+			m_queue.pop_front();
+			++m_uiDecoding;
+		}
+
+		const bool bNormalMap = image.bNormalMap;
+		const std::string cacheFilename = TextureCache::GetCacheFileName(image.filename.c_str(), bNormalMap);
+		image.pCache = new TextureCache();
+		image.bFromCache = image.pCache->Load(cacheFilename.c_str(), image.filename.c_str(), bNormalMap);
+
+		if (!image.bFromCache)
+		{
+			if (image.pCache->Decode(image.filename.c_str()))
+			{
+				// Files are already spread across the workers, so each is 
+				// compressed on one thread.
+				const unsigned int compressThreads = 1;
+				image.pCache->Compress(bNormalMap, compressThreads);
+				// Read only storage can't hold a cache, the texture still 
+				// loads without one.
+				image.pCache->Save(cacheFilename.c_str(), image.filename.c_str());
+			}
+			else
+			{
+				delete image.pCache;
+				image.pCache = nullptr;
+			}
+		}
+
+		// Files are identified by their contents, hashed here so the GL 
+		// thread never reads them. An up to date cache already holds the 
+		// hash.
+		if (image.bFromCache)
+		{
+			image.fileSize = image.pCache->GetSourceSize();
+			image.hash = image.pCache->GetSourceHash();
+			image.bHashed = true;
+		}
+		else if (image.pCache != nullptr)
+		{
+			OBJMappedFile file;
+			image.bHashed = file.Open(image.filename.c_str());
+			image.fileSize = file.GetSize();
+			image.hash = image.bHashed ? file.GetHash() : 0;
+		}
+
+		if (image.pCache != nullptr)
+		{
+			image.firstLevel = image.pCache->FindLevel(maxSize);
+			image.pCache->Prefetch(image.firstLevel);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decoded.push_back(image);
+			--m_uiDecoding;
+		}
+	}
+}
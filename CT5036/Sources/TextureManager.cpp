@@ -6,16 +6,64 @@
 
 #include "TextureManager.h" // File's header.
 #include "Texture.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "TextureDecoder.h"
+#include "TextureStreamer.h"
+#include "TextureTable.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 // Set up static pointer for singleton object.
 TextureManager* TextureManager::m_poInstance = nullptr;
+const unsigned int TextureManager::ms_uiCoarseSize = 64;
+const unsigned int TextureManager::ms_uiUnwrittenVersion = 0xFFFFFFFF;
 
-TextureManager::TextureManager() : m_pTextureMap()
+TextureManager::TextureManager() : m_pTextureMap(),
+	m_contentMap(),
+	m_atlasRegions(),
+	m_textures(),
+	m_freeHandles(),
+	m_recentlyUsed(),
+	m_poPlaceholder(nullptr),
+	m_poDecoder(new TextureDecoder(0)),
+	m_poStreamer(new TextureStreamer()),
+	m_poTextureTable(nullptr),
+	m_bBindless(true),
+	m_loadBudget(4 * 1024 * 1024),
+	m_residencyBudget((size_t)512 * 1024 * 1024),
+	m_uiFrame(0),
+	m_statistics(),
+	m_uiBatchTextures(0),
+	m_uiBatchCached(0),
+	m_batchStart()
 {}
 
 TextureManager::~TextureManager()
 {
+	// Stops the workers before the textures they're decoding for go.
+	delete m_poDecoder;
+	m_poDecoder = nullptr;
+	delete m_poStreamer;
+	m_poStreamer = nullptr;
+
+	for (auto iterator = m_textures.begin(); iterator != m_textures.end(); ++iterator)
+	{
+		delete iterator->pTexture;
+		iterator->pTexture = nullptr;
+	}
+
+	// Views in the table hold the textures' storage until they're freed.
+	delete m_poTextureTable;
+	m_poTextureTable = nullptr;
+	delete m_poPlaceholder;
+	m_poPlaceholder = nullptr;
 	m_pTextureMap.clear();
+	m_contentMap.clear();
 }
 
 TextureManager* TextureManager::CreateInstance()
@@ -48,83 +96,730 @@ void TextureManager::DestroyInstance()
 }
 
 // Uses an std map as a texture directory and reference counting.
-unsigned int TextureManager::LoadTexture(const char* a_pFilename)
+unsigned int TextureManager::LoadTexture(const char* a_pFilename, bool a_bNormalMap, glm::vec4* a_pUVTransform)
 {
+	if (a_pUVTransform != nullptr)
+	{
+		*a_pUVTransform = glm::vec4(1.f, 1.f, 0.f, 0.f);
+	}
+
 	if (a_pFilename != nullptr)
 	{
-		auto dictionaryIterator = m_pTextureMap.find(a_pFilename);
+		const std::string filename = NormalizePath(a_pFilename);
+		auto regionIterator = m_atlasRegions.find(filename);
+
+		// Packed textures share their atlas's texture and reference count.
+		if (regionIterator != m_atlasRegions.end())
+		{
+			const AtlasRegion& region = regionIterator->second;
+			const unsigned int atlas = LoadTexture(region.atlasFilename.c_str(), a_bNormalMap);
+			TextureReference& atlasReference = m_textures[ResolveHandle(atlas) - 1];
+			atlasReference.texelScale = std::max(atlasReference.texelScale,
+				std::max(1.f / region.uvTransform.x, 1.f / region.uvTransform.y));
+
+			if (a_pUVTransform != nullptr)
+			{
+				*a_pUVTransform = region.uvTransform;
+			}
+
+			return atlas;
+		}
+
+		const FileKey fileKey(filename, a_bNormalMap);
+		auto dictionaryIterator = m_pTextureMap.find(fileKey);
 
 		if (dictionaryIterator != m_pTextureMap.end())
 		{
 			// Texture is already in map, increment reference and return 
-			// texture ID.
-			TextureReference& textureReference = (TextureReference&)(dictionaryIterator->second);
-			++textureReference.referenceCount;
-			return textureReference.pTexture->GetTextureID();
+			// texture handle.
+			++m_textures[dictionaryIterator->second - 1].referenceCount;
+			return dictionaryIterator->second;
+		}
+
+		// Texture is not in dictionary. Draw it with the placeholder until 
+		// its file has been decoded. Files aren't read here, whether another 
+		// holds the same image is found once the workers have hashed it.
+		unsigned int handle = 0;
+
+		if (!m_freeHandles.empty())
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
 		}
-		// Texture is not in dictionary. Load it in from file.
 		else
 		{
-			Texture* pTexture = new Texture();
+			m_textures.push_back(TextureReference());
+			handle = (unsigned int)m_textures.size();
+		}
+
+		TextureReference& textureReference = m_textures[handle - 1];
+		textureReference.pTexture = new Texture();
+		textureReference.pTexture->SetFilename(filename.c_str());
+		textureReference.referenceCount = 1;
+		textureReference.bNormalMap = a_bNormalMap;
+		textureReference.bLoading = true;
+		// Never drawn, so it's the least recently used.
+		textureReference.lastUsedFrame = 0;
+		textureReference.requestedTexels = 0.f;
+		textureReference.texelScale = 1.f;
+		textureReference.recentlyUsed = m_recentlyUsed.insert(m_recentlyUsed.end(), handle);
+		// A reused handle's entry may still point at a released 
+		// texture.
+		textureReference.tableVersion = ms_uiUnwrittenVersion;
+		textureReference.contentKey = ContentKey(0, a_bNormalMap);
+		textureReference.bHashed = false;
+		textureReference.fileCount = 1;
+		textureReference.sharedHandle = 0;
+		m_pTextureMap[fileKey] = handle;
+
+		// Coarse mips are quick to read and upload, larger ones are 
+		// loaded once draws ask for them.
+		QueueDecode(filename, a_bNormalMap, ms_uiCoarseSize);
+		return handle;
+	}
+
+	return 0;
+}
+
+// Packs the small textures among the files into an atlas saved to the 
+// manifest, those loaded afterwards share the atlas's texture. Returns how 
+// many were packed.
+unsigned int TextureManager::PackAtlas(const char* a_pAtlasFilename, const std::vector<std::string>& a_filenames)
+{
+	TextureAtlas atlas;
+	const unsigned int packed = atlas.Pack(a_filenames);
+
+	if (packed == 0)
+	{
+		return 0;
+	}
+
+	// Read only storage can't hold the manifest, the textures are loaded 
+	// on their own instead.
+	if (!atlas.Save(a_pAtlasFilename))
+	{
+		std::cout << "Failed to save texture atlas: " << a_pAtlasFilename << std::endl;
+		return 0;
+	}
 
-			if (pTexture->Load(a_pFilename))
+	for (auto iterator = a_filenames.begin(); iterator != a_filenames.end(); ++iterator)
+	{
+		const TextureAtlas::Region* pRegion = atlas.FindRegion(*iterator);
+
+		if (pRegion != nullptr)
+		{
+			AtlasRegion region = { a_pAtlasFilename, atlas.GetUVTransform(*pRegion) };
+			m_atlasRegions[NormalizePath(iterator->c_str())] = region;
+		}
+	}
+
+	++m_statistics.atlases;
+	m_statistics.atlasedTextures += packed;
+	std::cout << "Packed " << packed << " textures into a " << atlas.GetWidth() << "x" << atlas.GetHeight() <<
+		" atlas: " << a_pAtlasFilename << std::endl;
+	return packed;
+}
+
+// Streams decoded textures to the GPU within the upload budget and frees 
+// textures past the memory budget. Must be called on the GL thread, once per 
+// frame.
+void TextureManager::FinalizeTextures()
+{
+	if (m_poPlaceholder == nullptr)
+	{
+		m_poPlaceholder = new Texture();
+		m_poPlaceholder->LoadPlaceholder();
+		m_poTextureTable = new TextureTable();
+		m_poTextureTable->Create(m_poPlaceholder->GetTextureID());
+	}
+
+	++m_uiFrame;
+	std::vector<TextureDecoder::Image> images;
+	m_poDecoder->TakeDecoded(images);
+
+	for (auto iterator = images.begin(); iterator != images.end(); ++iterator)
+	{
+		auto dictionaryIterator = m_pTextureMap.find(FileKey(iterator->filename, iterator->bNormalMap));
+
+		// Textures released or shared while decoding have nothing to upload 
+		// to.
+		if (dictionaryIterator == m_pTextureMap.end() ||
+			m_textures[dictionaryIterator->second - 1].pTexture == nullptr)
+		{
+			delete iterator->pCache;
+			continue;
+		}
+
+		const unsigned int handle = dictionaryIterator->second;
+		TextureReference& textureReference = m_textures[handle - 1];
+
+		// A texture's first image identifies its contents. Another file 
+		// with the same image keeps its handle but draws the first's 
+		// texture.
+		if (!textureReference.bHashed && iterator->bHashed)
+		{
+			const ContentKey contentKey(iterator->hash, textureReference.bNormalMap);
+			auto contentIterator = m_contentMap.find(contentKey);
+
+			if (contentIterator != m_contentMap.end() && contentIterator->second != handle)
 			{
-				// Successful load.
-				unsigned int referenceCount = 1;
-				TextureReference textureReference = { pTexture, referenceCount };
-				m_pTextureMap[a_pFilename] = textureReference;
-				return pTexture->GetTextureID();
+				ShareTexture(handle, contentIterator->second, iterator->fileSize);
+				delete iterator->pCache;
+				continue;
 			}
-			else
+
+			textureReference.contentKey = contentKey;
+			textureReference.bHashed = true;
+			m_contentMap[contentKey] = handle;
+		}
+
+		if (iterator->pCache == nullptr)
+		{
+			// The placeholder stays in place of textures that failed, and 
+			// they stay loading so they aren't retried every frame.
+			std::cout << "Failed to open image file: " << iterator->filename << std::endl;
+			continue;
+		}
+
+		m_uiBatchCached += iterator->bFromCache ? 1 : 0;
+		m_poStreamer->Queue(textureReference.pTexture,
+			iterator->pCache,
+			iterator->firstLevel);
+	}
+
+	const bool bStreaming = m_poStreamer->GetPendingCount() > 0;
+	m_poStreamer->Update();
+	std::vector<Texture*> completed;
+	m_poStreamer->TakeCompleted(completed);
+
+	// A file can be both a normal map and not, so textures are matched 
+	// rather than looked up by filename.
+	for (auto iterator = completed.begin(); iterator != completed.end(); ++iterator)
+	{
+		for (auto textureIterator = m_textures.begin(); textureIterator != m_textures.end(); ++textureIterator)
+		{
+			if (textureIterator->pTexture == *iterator)
 			{
-				delete pTexture;
-				return 0;
+				textureIterator->bLoading = false;
+				break;
 			}
 		}
 	}
 
-	return 0;
+	if (bStreaming && GetPendingCount() == 0)
+	{
+		const std::chrono::duration<double> batchTime = std::chrono::high_resolution_clock::now() - m_batchStart;
+		std::cout << "Loaded " << m_uiBatchTextures << " textures (" <<
+			m_uiBatchCached << " from cache) on " <<
+			m_poDecoder->GetThreadCount() << " decode thread(s) in " <<
+			batchTime.count() * 1000.0 << "ms, streaming " <<
+			m_poStreamer->GetBudget() / 1024 << "KB per frame." << std::endl;
+	}
+
+	UpdateResolutions();
+	EnforceResidencyBudget();
+	UpdateTextureTable();
+}
+
+// Marks a texture as used this frame by a draw needing the given texels 
+// across each unit of UV. 0 asks for the full image.
+void TextureManager::RequestTexture(unsigned int a_texture, float a_texelsPerUV)
+{
+	a_texture = ResolveHandle(a_texture);
+
+	if (a_texture == 0 || a_texture > m_textures.size() || m_textures[a_texture - 1].pTexture == nullptr)
+	{
+		return;
+	}
+
+	TextureReference& textureReference = m_textures[a_texture - 1];
+	const float texels = a_texelsPerUV > 0.f ?
+		a_texelsPerUV * textureReference.texelScale :
+		std::numeric_limits<float>::max();
+
+	if (textureReference.lastUsedFrame != m_uiFrame)
+	{
+		textureReference.lastUsedFrame = m_uiFrame;
+		textureReference.requestedTexels = texels;
+		m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed, textureReference.recentlyUsed);
+	}
+	else
+	{
+		textureReference.requestedTexels = std::max(textureReference.requestedTexels, texels);
+	}
+}
+
+// GL name to bind for a texture, the placeholder's if it isn't resident.
+unsigned int TextureManager::GetTextureName(unsigned int a_texture) const
+{
+	const unsigned int placeholder = m_poPlaceholder != nullptr ? m_poPlaceholder->GetTextureID() : 0;
+	a_texture = ResolveHandle(a_texture);
+
+	if (a_texture == 0 || a_texture > m_textures.size() || m_textures[a_texture - 1].pTexture == nullptr)
+	{
+		return placeholder;
+	}
+
+	const unsigned int textureID = m_textures[a_texture - 1].pTexture->GetTextureID();
+	return textureID != 0 ? textureID : placeholder;
 }
 
-unsigned int TextureManager::GetTexture(const char* a_pFilename)
+// Draws sample textures through the texture table rather than binding them, 
+// ignored when bindless textures are unsupported.
+void TextureManager::SetBindless(bool a_bBindless)
 {
-	auto dictionaryIterator = m_pTextureMap.find(a_pFilename);
+	m_bBindless = a_bBindless;
+}
+
+bool TextureManager::IsBindless() const
+{
+	return m_bBindless && m_poTextureTable != nullptr && m_poTextureTable->IsSupported();
+}
+
+// Textures still being decoded or uploaded.
+unsigned int TextureManager::GetPendingCount() const
+{
+	return m_poDecoder->GetPendingCount() + m_poStreamer->GetPendingCount();
+}
+
+// Texture bytes uploaded per frame.
+void TextureManager::SetUploadBudget(unsigned int a_bytes)
+{
+	m_poStreamer->SetBudget(a_bytes);
+}
+
+unsigned int TextureManager::GetUploadBudget() const
+{
+	return m_poStreamer->GetBudget();
+}
+
+// Bytes of mips that loads may read from disk per frame, at least one load 
+// is queued a frame.
+void TextureManager::SetLoadBudget(size_t a_bytes)
+{
+	m_loadBudget = a_bytes;
+}
+
+size_t TextureManager::GetLoadBudget() const
+{
+	return m_loadBudget;
+}
+
+// GPU bytes textures may hold before the least recently used are freed.
+void TextureManager::SetResidencyBudget(size_t a_bytes)
+{
+	m_residencyBudget = a_bytes;
+}
+
+size_t TextureManager::GetResidencyBudget() const
+{
+	return m_residencyBudget;
+}
+
+const TextureManager::Statistics& TextureManager::GetStatistics() const
+{
+	return m_statistics;
+}
+
+unsigned int TextureManager::GetTexture(const char* a_pFilename, bool a_bNormalMap)
+{
+	auto dictionaryIterator = m_pTextureMap.find(FileKey(NormalizePath(a_pFilename), a_bNormalMap));
 
 	if (dictionaryIterator != m_pTextureMap.end())
 	{
-		TextureReference& textureReference =
-			(TextureReference&)(dictionaryIterator->second);
-		++textureReference.referenceCount;
-		return textureReference.pTexture->GetTextureID();
+		++m_textures[dictionaryIterator->second - 1].referenceCount;
+		return dictionaryIterator->second;
 	}
 
 	return 0;
 }
 
-bool TextureManager::TextureExists(const char* a_pTextureName)
+bool TextureManager::TextureExists(const char* a_pTextureName, bool a_bNormalMap)
 {
-	auto dictionaryIterator = m_pTextureMap.find(a_pTextureName);
+	auto dictionaryIterator = m_pTextureMap.find(FileKey(NormalizePath(a_pTextureName), a_bNormalMap));
 	return (dictionaryIterator != m_pTextureMap.end());
 }
 
 void TextureManager::ReleaseTexture(unsigned int a_texture)
 {
-	for (auto dictionaryIterator = m_pTextureMap.begin();
-		dictionaryIterator != m_pTextureMap.end();
-		++dictionaryIterator)
+	if (a_texture == 0 || a_texture > m_textures.size())
 	{
-		TextureReference& textureReference =
-			(TextureReference&)(dictionaryIterator->second);
+		return;
+	}
+
+	TextureReference& textureReference = m_textures[a_texture - 1];
 
-		if (a_texture == textureReference.pTexture->GetTextureID())
+	// Handles sharing another's texture hold a reference to it, dropped 
+	// with their last one.
+	if (textureReference.sharedHandle != 0)
+	{
+		if (--textureReference.referenceCount == 0)
 		{
-			if (--textureReference.referenceCount == 0)
+			const unsigned int sharedHandle = textureReference.sharedHandle;
+
+			for (auto iterator = m_pTextureMap.begin(); iterator != m_pTextureMap.end();)
+			{
+				iterator = iterator->second == a_texture ? m_pTextureMap.erase(iterator) : ++iterator;
+			}
+
+			textureReference.sharedHandle = 0;
+			textureReference.tableVersion = ms_uiUnwrittenVersion;
+			m_freeHandles.push_back(a_texture);
+			--m_textures[sharedHandle - 1].fileCount;
+			ReleaseTexture(sharedHandle);
+		}
+
+		return;
+	}
+
+	if (textureReference.pTexture != nullptr && --textureReference.referenceCount == 0)
+	{
+		m_poStreamer->Cancel(textureReference.pTexture);
+
+		// Every file sharing the texture is removed with it.
+		for (auto iterator = m_pTextureMap.begin(); iterator != m_pTextureMap.end();)
+		{
+			iterator = iterator->second == a_texture ? m_pTextureMap.erase(iterator) : ++iterator;
+		}
+
+		if (textureReference.bHashed)
+		{
+			m_contentMap.erase(textureReference.contentKey);
+		}
+
+		m_recentlyUsed.erase(textureReference.recentlyUsed);
+		delete textureReference.pTexture;
+		textureReference.pTexture = nullptr;
+		textureReference.tableVersion = ms_uiUnwrittenVersion;
+		m_freeHandles.push_back(a_texture);
+	}
+}
+
+// Separators become forward slashes, and empty, '.' and resolvable '..' 
+// components are removed.
+std::string TextureManager::NormalizePath(const char* a_pFilename)
+{
+	std::string path = a_pFilename != nullptr ? a_pFilename : "";
+	std::replace(path.begin(), path.end(), '\\', '/');
+	const bool bAbsolute = !path.empty() && path[0] == '/';
+	std::vector<std::string> components;
+	std::istringstream stream(path);
+	std::string component;
+
+	while (std::getline(stream, component, '/'))
+	{
+		if (component.empty() || component == ".")
+		{
+			continue;
+		}
+
+		// Leading '..' of relative paths can't be resolved and are kept.
+		if (component == ".." && !components.empty() && components.back() != "..")
+		{
+			components.pop_back();
+			continue;
+		}
+
+		components.push_back(component);
+	}
+
+	std::string normalized = bAbsolute ? "/" : "";
+
+	for (auto iterator = components.begin(); iterator != components.end(); ++iterator)
+	{
+		normalized += (iterator != components.begin() ? "/" : "") + *iterator;
+	}
+
+	return normalized;
+}
+
+// Handle of the texture drawn for a handle, which differs when its file 
+// shares another's texture.
+unsigned int TextureManager::ResolveHandle(unsigned int a_texture) const
+{
+	if (a_texture == 0 || a_texture > m_textures.size() || m_textures[a_texture - 1].sharedHandle == 0)
+	{
+		return a_texture;
+	}
+
+	return m_textures[a_texture - 1].sharedHandle;
+}
+
+// Drops a texture whose file turned out to hold the same image as another, 
+// its handle draws the other's texture from then on.
+void TextureManager::ShareTexture(unsigned int a_texture, unsigned int a_sharedTexture, unsigned long long a_fileSize)
+{
+	TextureReference& textureReference = m_textures[a_texture - 1];
+	TextureReference& sharedReference = m_textures[a_sharedTexture - 1];
+	m_poStreamer->Cancel(textureReference.pTexture);
+	m_recentlyUsed.erase(textureReference.recentlyUsed);
+	delete textureReference.pTexture;
+	textureReference.pTexture = nullptr;
+	textureReference.bLoading = false;
+	textureReference.sharedHandle = a_sharedTexture;
+	// Points the handle's table entry at the shared texture.
+	textureReference.tableVersion = ms_uiUnwrittenVersion;
+	// Draws already asked for through the handle carry over.
+	sharedReference.texelScale = std::max(sharedReference.texelScale, textureReference.texelScale);
+
+	if (textureReference.lastUsedFrame > sharedReference.lastUsedFrame)
+	{
+		sharedReference.lastUsedFrame = textureReference.lastUsedFrame;
+		sharedReference.requestedTexels = textureReference.requestedTexels;
+		m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed, sharedReference.recentlyUsed);
+	}
+
+	++sharedReference.referenceCount;
+	++sharedReference.fileCount;
+	++m_statistics.sharedTextures;
+	m_statistics.sharedFileBytes += (size_t)a_fileSize;
+}
+
+// Queues a file's levels up to the maximum size to be decoded, starting a 
+// new batch if nothing is pending.
+void TextureManager::QueueDecode(const std::string& a_filename, bool a_bNormalMap, unsigned int a_maxSize)
+{
+	if (GetPendingCount() == 0)
+	{
+		m_uiBatchTextures = 0;
+		m_uiBatchCached = 0;
+		m_batchStart = std::chrono::high_resolution_clock::now();
+	}
+
+	m_poDecoder->Queue(a_filename.c_str(), a_bNormalMap, a_maxSize);
+	++m_uiBatchTextures;
+}
+
+// Smallest level of a loaded texture with at least the requested texels 
+// across.
+unsigned int TextureManager::GetWantedLevel(const TextureReference& a_textureReference) const
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	a_textureReference.pTexture->GetDimensions(width, height);
+	const unsigned int size = std::max(width, height);
+	unsigned int level = 0;
+
+	while (level + 1 < a_textureReference.pTexture->GetLevelCount() &&
+		(float)(size >> (level + 1)) >= a_textureReference.requestedTexels)
+	{
+		++level;
+	}
+
+	return level;
+}
+
+// Queues loads for textures drawn last frame without the mips they need, 
+// those furthest from them first, and demotes those with more than they 
+// need.
+void TextureManager::UpdateResolutions()
+{
+	// Textures not yet resident come first, then by how many levels short 
+	// they are.
+	std::vector<std::pair<unsigned int, unsigned int>> loads;
+
+	for (unsigned int handle = 1; handle <= m_textures.size(); ++handle)
+	{
+		TextureReference& textureReference = m_textures[handle - 1];
+		Texture* pTexture = textureReference.pTexture;
+
+		if (pTexture == nullptr || textureReference.lastUsedFrame + 1 != m_uiFrame)
+		{
+			continue;
+		}
+
+		const bool bResident = pTexture->GetTextureID() != 0;
+		const unsigned int wantedLevel = GetWantedLevel(textureReference);
+		const unsigned int baseLevel = pTexture->GetBaseLevel();
+
+		if (bResident && baseLevel <= wantedLevel)
+		{
+			++m_statistics.hits;
+		}
+		else
+		{
+			++m_statistics.misses;
+		}
+
+		if (textureReference.bLoading)
+		{
+			continue;
+		}
+
+		if (!bResident || baseLevel > wantedLevel)
+		{
+			loads.push_back(std::make_pair(bResident ? baseLevel - wantedLevel : pTexture->GetLevelCount() + 1,
+				handle));
+			continue;
+		}
+
+		// A level of slack keeps textures on the edge of two levels from 
+		// loading and dropping a mip every few frames.
+		unsigned int width = 0;
+		unsigned int height = 0;
+		pTexture->GetDimensions(width, height);
+
+		if (baseLevel + 1 < wantedLevel &&
+			std::max(width, height) >> (baseLevel + 1) >= ms_uiCoarseSize &&
+			pTexture->Demote())
+		{
+			++m_statistics.demotions;
+		}
+	}
+
+	std::sort(loads.begin(), loads.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+	size_t bytesRequested = 0;
+
+	for (auto iterator = loads.begin(); iterator != loads.end() && bytesRequested < m_loadBudget; ++iterator)
+	{
+		TextureReference& textureReference = m_textures[iterator->second - 1];
+		Texture* pTexture = textureReference.pTexture;
+		unsigned int width = 0;
+		unsigned int height = 0;
+		pTexture->GetDimensions(width, height);
+		const unsigned int size = std::max(width, height);
+		const unsigned int wantedLevel = GetWantedLevel(textureReference);
+		// Evicted textures come back coarse first, like newly loaded ones.
+		unsigned int firstLevel = wantedLevel;
+		unsigned int endLevel = pTexture->GetBaseLevel();
+
+		if (pTexture->GetTextureID() == 0)
+		{
+			endLevel = pTexture->GetLevelCount();
+
+			while (firstLevel + 1 < endLevel && size >> firstLevel > ms_uiCoarseSize)
+			{
+				++firstLevel;
+			}
+		}
+
+		// Textures never loaded have no levels to size yet.
+		const unsigned int maxSize = pTexture->GetLevelCount() > 0 ? std::max(size >> firstLevel, 1u) : ms_uiCoarseSize;
+		const size_t bytes = pTexture->GetLevelsSize(firstLevel, endLevel);
+		textureReference.bLoading = true;
+		QueueDecode(pTexture->GetFileName(), textureReference.bNormalMap, maxSize);
+		bytesRequested += bytes;
+		m_statistics.bytesRequested += bytes;
+		++m_statistics.loads;
+	}
+}
+
+// Demotes then evicts the least recently used textures until the resident 
+// bytes fit the budget. Textures used last frame are kept.
+void TextureManager::EnforceResidencyBudget()
+{
+	size_t residentBytes = 0;
+	// Each file sharing a texture would otherwise hold its own copy.
+	size_t sharedBytes = 0;
+
+	for (auto iterator = m_textures.begin(); iterator != m_textures.end(); ++iterator)
+	{
+		if (iterator->pTexture != nullptr)
+		{
+			residentBytes += iterator->pTexture->GetSize();
+			sharedBytes += iterator->pTexture->GetSize() * (iterator->fileCount - 1);
+		}
+	}
+
+	m_statistics.peakResidentBytes = std::max(m_statistics.peakResidentBytes, residentBytes);
+	m_statistics.sharedResidentBytes = std::max(m_statistics.sharedResidentBytes, sharedBytes);
+
+	for (auto iterator = m_recentlyUsed.rbegin();
+		iterator != m_recentlyUsed.rend() && residentBytes > m_residencyBudget;
+		++iterator)
+	{
+		TextureReference& textureReference = m_textures[*iterator - 1];
+		Texture* pTexture = textureReference.pTexture;
+
+		if (textureReference.lastUsedFrame + 1 >= m_uiFrame || pTexture->GetSize() == 0)
+		{
+			continue;
+		}
+
+		// Halving a texture frees three quarters of it while still leaving 
+		// something to draw, so it's tried before eviction.
+		unsigned int width = 0;
+		unsigned int height = 0;
+		pTexture->GetDimensions(width, height);
+
+		while (residentBytes > m_residencyBudget &&
+			std::max(width, height) >> (pTexture->GetBaseLevel() + 1) >= ms_uiCoarseSize)
+		{
+			const size_t size = pTexture->GetSize();
+
+			if (!pTexture->Demote())
 			{
-				delete textureReference.pTexture;
-				textureReference.pTexture = nullptr;
-				m_pTextureMap.erase(dictionaryIterator);
 				break;
 			}
+
+			residentBytes -= size - pTexture->GetSize();
+			++m_statistics.demotions;
+		}
+
+		if (residentBytes > m_residencyBudget)
+		{
+			residentBytes -= pTexture->GetSize();
+
+			// A cancelled upload must be queued again the next time the 
+			// texture's drawn.
+			if (m_poStreamer->Cancel(pTexture))
+			{
+				textureReference.bLoading = false;
+			}
+
+			pTexture->Evict();
+			++m_statistics.evictions;
 		}
 	}
+
+	m_statistics.residentBytes = residentBytes;
+}
+
+// Points the texture table's entries at the names textures hold after this 
+// frame's uploads, demotions and evictions.
+void TextureManager::UpdateTextureTable()
+{
+	if (!m_poTextureTable->IsSupported())
+	{
+		return;
+	}
+
+	// Kept current even while textures are bound, so switching to bindless 
+	// draws needs no catching up.
+	for (unsigned int handle = 1; handle <= m_textures.size(); ++handle)
+	{
+		TextureReference& textureReference = m_textures[handle - 1];
+		// Handles sharing a texture point at its storage.
+		Texture* pTexture = m_textures[ResolveHandle(handle) - 1].pTexture;
+
+		// Names can be reused once deleted, so the storage version is 
+		// compared instead.
+		if (textureReference.tableVersion != ms_uiUnwrittenVersion &&
+			(pTexture == nullptr || pTexture->GetStorageVersion() == textureReference.tableVersion))
+		{
+			continue;
+		}
+
+		const unsigned int name = pTexture != nullptr ? pTexture->GetTextureID() : 0;
+
+		if (name != 0)
+		{
+			m_poTextureTable->Set(handle,
+				name,
+				pTexture->GetInternalFormat(),
+				pTexture->GetLevelCount() - pTexture->GetBaseLevel());
+		}
+		else
+		{
+			const unsigned int noFormat = 0;
+			const unsigned int noLevels = 0;
+			m_poTextureTable->Set(handle, name, noFormat, noLevels);
+		}
+
+		textureReference.tableVersion = pTexture != nullptr ? pTexture->GetStorageVersion() : 0;
+		++m_statistics.tableUpdates;
+	}
+
+	m_poTextureTable->Update();
+	m_poTextureTable->Bind();
 }
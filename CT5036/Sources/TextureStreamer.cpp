@@ -0,0 +1,228 @@
+//////////////////////////////
+// File: TextureStreamer.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "TextureStreamer.h" // File's header.
+#include <algorithm>
+#include <cstring>
+#include "Texture.h"
+#include "TextureCache.h"
+
+const unsigned int TextureStreamer::ms_uiSegmentSize = 8 * 1024 * 1024;
+
+TextureStreamer::TextureStreamer() : m_uiBuffer(0),
+	m_uiBudget(4 * 1024 * 1024),
+	m_uiSegment(0),
+	m_pMappedBuffer(nullptr),
+	m_fences(),
+	m_uploads(),
+	m_completed(),
+	m_frameStatistics()
+{}
+
+TextureStreamer::~TextureStreamer()
+{
+	for (auto iterator = m_uploads.begin(); iterator != m_uploads.end(); ++iterator)
+	{
+		delete iterator->pCache;
+	}
+
+	for (unsigned int segment = 0; segment < ms_uiSegmentCount; ++segment)
+	{
+		if (m_fences[segment])
+		{
+			glDeleteSync(m_fences[segment]);
+		}
+	}
+
+	if (m_uiBuffer != 0)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uiBuffer);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		const GLsizei toDelete = 1;
+		glDeleteBuffers(toDelete, &m_uiBuffer);
+	}
+}
+
+// Queues a texture's mips from the first level down, the cache is deleted 
+// once they're uploaded. Levels the texture already holds are copied on the 
+// GPU instead.
+void TextureStreamer::Queue(Texture* a_pTexture, TextureCache* a_pCache, unsigned int a_firstLevel)
+{
+	Upload upload = { a_pTexture, a_pCache, a_firstLevel, 0, 0, false };
+	m_uploads.push_back(upload);
+}
+
+// Drops a texture's queued upload, for textures about to be deleted or 
+// evicted. Returns whether there was one.
+bool TextureStreamer::Cancel(const Texture* a_pTexture)
+{
+	bool bCancelled = false;
+
+	for (auto iterator = m_uploads.begin(); iterator != m_uploads.end();)
+	{
+		if (iterator->pTexture == a_pTexture)
+		{
+			delete iterator->pCache;
+			iterator = m_uploads.erase(iterator);
+			bCancelled = true;
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	m_completed.erase(std::remove(m_completed.begin(), m_completed.end(), a_pTexture), m_completed.end());
+	return bCancelled;
+}
+
+// Uploads up to the budget's worth of queued rows. Must be called on the GL 
+// thread, once per frame.
+void TextureStreamer::Update()
+{
+	m_frameStatistics = Statistics();
+
+	if (m_uploads.empty())
+	{
+		return;
+	}
+
+	if (m_uiBuffer == 0)
+	{
+		// Persistent, coherent mapping lets rows be written straight into 
+		// the buffer while the GPU reads other segments.
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLsizei toGenerate = 1;
+		glGenBuffers(toGenerate, &m_uiBuffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uiBuffer);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, ms_uiSegmentCount * ms_uiSegmentSize, nullptr, flags);
+		m_pMappedBuffer = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+			0,
+			ms_uiSegmentCount * ms_uiSegmentSize,
+			flags);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	// A segment still being read is left for next frame rather than waited 
+	// on.
+	GLsync& fence = m_fences[m_uiSegment];
+
+	if (fence)
+	{
+		const GLuint64 timeout = 0;
+
+		if (glClientWaitSync(fence, 0, timeout) == GL_TIMEOUT_EXPIRED)
+		{
+			++m_frameStatistics.segmentsBusy;
+			return;
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	const unsigned int segmentOffset = m_uiSegment * ms_uiSegmentSize;
+	unsigned int segmentUsed = 0;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uiBuffer);
+
+	while (!m_uploads.empty())
+	{
+		Upload& upload = m_uploads.front();
+		const TextureCache& cache = *upload.pCache;
+
+		if (!upload.bAllocated)
+		{
+			upload.endLevel = upload.pTexture->Allocate(cache.GetWidth(),
+				cache.GetHeight(),
+				cache.GetLevelCount(),
+				cache.GetFormat(),
+				upload.level);
+			upload.bAllocated = true;
+		}
+
+		if (upload.level == upload.endLevel)
+		{
+			// GL orders the uploads before any draw using the new name.
+			upload.pTexture->Commit();
+			m_completed.push_back(upload.pTexture);
+			delete upload.pCache;
+			m_uploads.pop_front();
+			++m_frameStatistics.texturesCompleted;
+			continue;
+		}
+
+		// Rows are rows of texels, or of blocks for compressed textures.
+		const unsigned int levelRows = cache.GetRowCount(upload.level);
+		const unsigned int rowSize = cache.GetRowSize(upload.level);
+		// A budget smaller than a row still lets one row through a frame.
+		const unsigned int budget = segmentUsed == 0 ? std::max(m_uiBudget, rowSize) : m_uiBudget;
+		const unsigned int rowCount = std::min(levelRows - upload.nextRow,
+			(budget - std::min(budget, segmentUsed)) / rowSize);
+
+		if (rowCount == 0)
+		{
+			break;
+		}
+
+		// Segment offsets stay four byte aligned, as every row's size is.
+		const unsigned int offset = segmentOffset + segmentUsed;
+		const unsigned int size = rowCount * rowSize;
+		memcpy(m_pMappedBuffer + offset, cache.GetLevel(upload.level) + (size_t)upload.nextRow * rowSize, size);
+		// The last block row can cover fewer texel rows than a whole block.
+		const unsigned int firstTexelRow = upload.nextRow * cache.GetRowHeight();
+		const unsigned int texelRows = std::min((upload.nextRow + rowCount) * cache.GetRowHeight(),
+			cache.GetLevelHeight(upload.level)) - firstTexelRow;
+		upload.pTexture->UploadRows(upload.level, firstTexelRow, texelRows, (const void*)(size_t)offset, size);
+		upload.nextRow += rowCount;
+		segmentUsed += size;
+
+		if (upload.nextRow == levelRows)
+		{
+			upload.nextRow = 0;
+			++upload.level;
+		}
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	m_frameStatistics.bytesUploaded = segmentUsed;
+
+	if (segmentUsed > 0)
+	{
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_uiSegment = (m_uiSegment + 1) % ms_uiSegmentCount;
+	}
+}
+
+// Bytes uploaded per frame, at most one segment's size.
+void TextureStreamer::SetBudget(unsigned int a_bytes)
+{
+	m_uiBudget = std::min(a_bytes, ms_uiSegmentSize);
+}
+
+unsigned int TextureStreamer::GetBudget() const
+{
+	return m_uiBudget;
+}
+
+// Textures with rows still to upload.
+unsigned int TextureStreamer::GetPendingCount() const
+{
+	return (unsigned int)m_uploads.size();
+}
+
+// Moves every texture committed since the last call into the list.
+void TextureStreamer::TakeCompleted(std::vector<Texture*>& a_textures)
+{
+	a_textures.insert(a_textures.end(), m_completed.begin(), m_completed.end());
+	m_completed.clear();
+}
+
+// Counters for the last Update call.
+const TextureStreamer::Statistics& TextureStreamer::GetFrameStatistics() const
+{
+	return m_frameStatistics;
+}
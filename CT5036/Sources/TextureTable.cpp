@@ -0,0 +1,271 @@
+//////////////////////////////
+// File: TextureTable.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "TextureTable.h" // File's header.
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "ShaderConstants.h"
+#ifdef WIN64
+#include "GLFW/glfw3.h"
+#endif // WIN64.
+
+// ARB_bindless_texture isn't part of the generated loader, so its entry 
+// points are fetched when the table is created.
+typedef GLuint64 (APIENTRYP PFNGETTEXTURESAMPLERHANDLE)(GLuint a_texture, GLuint a_sampler);
+typedef void (APIENTRYP PFNMAKETEXTUREHANDLERESIDENT)(GLuint64 a_handle);
+typedef void (APIENTRYP PFNMAKETEXTUREHANDLENONRESIDENT)(GLuint64 a_handle);
+
+static PFNGETTEXTURESAMPLERHANDLE spGetTextureSamplerHandle = nullptr;
+static PFNMAKETEXTUREHANDLERESIDENT spMakeTextureHandleResident = nullptr;
+static PFNMAKETEXTUREHANDLENONRESIDENT spMakeTextureHandleNonResident = nullptr;
+
+TextureTable::TextureTable() : m_bSupported(false),
+	m_uiBuffer(0),
+	m_uiCapacity(0),
+	m_uiSampler(0),
+	m_uiUpdateCount(0),
+	m_uiFirstDirty(0),
+	m_uiEndDirty(0),
+	m_placeholderHandle(0),
+	m_entries(),
+	m_handles(),
+	m_retiring(),
+	m_retired()
+{}
+
+TextureTable::~TextureTable()
+{
+	if (!m_bSupported)
+	{
+		return;
+	}
+
+	for (auto iterator = m_retired.begin(); iterator != m_retired.end(); ++iterator)
+	{
+		glDeleteSync(iterator->fence);
+		m_retiring.insert(m_retiring.end(), iterator->entries.begin(), iterator->entries.end());
+	}
+
+	m_retiring.insert(m_retiring.end(), m_entries.begin(), m_entries.end());
+
+	for (auto iterator = m_retiring.begin(); iterator != m_retiring.end(); ++iterator)
+	{
+		Release(*iterator);
+	}
+
+	spMakeTextureHandleNonResident(m_placeholderHandle);
+	const GLsizei toDelete = 1;
+	glDeleteSamplers(toDelete, &m_uiSampler);
+	glDeleteBuffers(toDelete, &m_uiBuffer);
+}
+
+// Loads the extension's entry points and makes the placeholder's handle, 
+// false when the driver doesn't support bindless textures. Must be called on 
+// the GL thread.
+bool TextureTable::Create(unsigned int a_placeholder)
+{
+#ifdef WIN64
+	GLint extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+	for (GLint i = 0; i < extensionCount && !m_bSupported; ++i)
+	{
+		m_bSupported = std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_ARB_bindless_texture") == 0;
+	}
+
+	if (m_bSupported)
+	{
+		spGetTextureSamplerHandle = (PFNGETTEXTURESAMPLERHANDLE)glfwGetProcAddress("glGetTextureSamplerHandleARB");
+		spMakeTextureHandleResident = (PFNMAKETEXTUREHANDLERESIDENT)glfwGetProcAddress("glMakeTextureHandleResidentARB");
+		spMakeTextureHandleNonResident =
+			(PFNMAKETEXTUREHANDLENONRESIDENT)glfwGetProcAddress("glMakeTextureHandleNonResidentARB");
+		m_bSupported = spGetTextureSamplerHandle && spMakeTextureHandleResident && spMakeTextureHandleNonResident;
+	}
+#endif // WIN64.
+
+	if (!m_bSupported)
+	{
+		std::cout << "Bindless textures unsupported, textures are bound per draw." << std::endl;
+		return false;
+	}
+
+	// Matches the sampling state textures are given when they're created.
+	const GLsizei toGenerate = 1;
+	glGenSamplers(toGenerate, &m_uiSampler);
+	glSamplerParameteri(m_uiSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_uiSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glSamplerParameteri(m_uiSampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glSamplerParameteri(m_uiSampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	m_placeholderHandle = spGetTextureSamplerHandle(a_placeholder, m_uiSampler);
+	spMakeTextureHandleResident(m_placeholderHandle);
+	// Entry 0 is no texture.
+	const Entry placeholder = { 0, m_placeholderHandle };
+	m_entries.push_back(placeholder);
+	m_handles.push_back(m_placeholderHandle);
+	m_uiEndDirty = 1;
+	std::cout << "Bindless textures supported." << std::endl;
+	return true;
+}
+
+bool TextureTable::IsSupported() const
+{
+	return m_bSupported;
+}
+
+// Points an entry at a texture's resident mips, or at the placeholder when 
+// the name is 0. The table grows to fit the index.
+void TextureTable::Set(unsigned int a_index,
+	unsigned int a_name,
+	unsigned int a_internalFormat,
+	unsigned int a_levelCount)
+{
+	if (!m_bSupported)
+	{
+		return;
+	}
+
+	if (m_uiFirstDirty == m_uiEndDirty)
+	{
+		m_uiFirstDirty = a_index;
+		m_uiEndDirty = a_index + 1;
+	}
+	else
+	{
+		m_uiFirstDirty = std::min(m_uiFirstDirty, a_index);
+		m_uiEndDirty = std::max(m_uiEndDirty, a_index + 1);
+	}
+
+	if (a_index >= m_entries.size())
+	{
+		// Entries in between have no texture yet.
+		m_uiFirstDirty = std::min(m_uiFirstDirty, (unsigned int)m_entries.size());
+		const Entry placeholder = { 0, m_placeholderHandle };
+		m_entries.resize(a_index + 1, placeholder);
+		m_handles.resize(a_index + 1, m_placeholderHandle);
+	}
+
+	// Frames already submitted may still read the old view.
+	Entry& entry = m_entries[a_index];
+
+	if (entry.view != 0)
+	{
+		m_retiring.push_back(entry);
+	}
+
+	entry.view = 0;
+	entry.handle = m_placeholderHandle;
+
+	if (a_name != 0)
+	{
+		const GLsizei toGenerate = 1;
+		const GLuint firstLevel = 0;
+		const GLuint firstLayer = 0;
+		const GLuint layerCount = 1;
+		glGenTextures(toGenerate, &entry.view);
+		glTextureView(entry.view,
+			GL_TEXTURE_2D,
+			a_name,
+			a_internalFormat,
+			firstLevel,
+			a_levelCount,
+			firstLayer,
+			layerCount);
+		entry.handle = spGetTextureSamplerHandle(entry.view, m_uiSampler);
+		spMakeTextureHandleResident(entry.handle);
+	}
+
+	m_handles[a_index] = entry.handle;
+	++m_uiUpdateCount;
+}
+
+// Copies changed entries to the buffer and frees views the GPU has finished 
+// with. Called once per frame before drawing.
+void TextureTable::Update()
+{
+	if (!m_bSupported)
+	{
+		return;
+	}
+
+	// The fence follows every draw that could have read the views being 
+	// replaced, later draws read the new entries.
+	if (!m_retiring.empty())
+	{
+		RetiredViews retired;
+		retired.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		retired.entries.swap(m_retiring);
+		m_retired.push_back(retired);
+	}
+
+	const GLuint64 timeout = 0;
+
+	while (!m_retired.empty() && glClientWaitSync(m_retired.front().fence, 0, timeout) != GL_TIMEOUT_EXPIRED)
+	{
+		for (auto iterator = m_retired.front().entries.begin(); iterator != m_retired.front().entries.end(); ++iterator)
+		{
+			Release(*iterator);
+		}
+
+		glDeleteSync(m_retired.front().fence);
+		m_retired.pop_front();
+	}
+
+	if (m_handles.size() > m_uiCapacity || m_uiBuffer == 0)
+	{
+		// Immutable storage can't grow, so replace it with room to spare 
+		// for textures loaded later.
+		const GLsizei buffers = 1;
+		const unsigned int minimumCapacity = 64;
+		glDeleteBuffers(buffers, &m_uiBuffer);
+		glGenBuffers(buffers, &m_uiBuffer);
+		m_uiCapacity = std::max(std::max((unsigned int)m_handles.size(), m_uiCapacity * 2), minimumCapacity);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiBuffer);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER, m_uiCapacity * sizeof(GLuint64), nullptr, GL_DYNAMIC_STORAGE_BIT);
+		m_uiFirstDirty = 0;
+		m_uiEndDirty = (unsigned int)m_handles.size();
+	}
+	else
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiBuffer);
+	}
+
+	if (m_uiFirstDirty < m_uiEndDirty)
+	{
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+			m_uiFirstDirty * sizeof(GLuint64),
+			(m_uiEndDirty - m_uiFirstDirty) * sizeof(GLuint64),
+			m_handles.data() + m_uiFirstDirty);
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	m_uiFirstDirty = 0;
+	m_uiEndDirty = 0;
+}
+
+void TextureTable::Bind() const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ShaderConstants::BINDINGS_TEXTURES, m_uiBuffer);
+}
+
+// Entries changed since the table was created.
+unsigned int TextureTable::GetUpdateCount() const
+{
+	return m_uiUpdateCount;
+}
+
+// Makes the entry's handle non-resident and deletes its view.
+void TextureTable::Release(const Entry& a_entry) const
+{
+	if (a_entry.view == 0)
+	{
+		return;
+	}
+
+	const GLsizei toDelete = 1;
+	spMakeTextureHandleNonResident(a_entry.handle);
+	glDeleteTextures(toDelete, &a_entry.view);
+}
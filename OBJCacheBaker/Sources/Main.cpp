@@ -0,0 +1,223 @@
+//////////////////////////////
+// File: Main.cpp.
+// Author: Liam Bansal.
+// Date Created: 17/10/2026.
+//////////////////////////////
+
+#include "OBJLoader.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Parses the model on each thread count, keeping the fastest of a few runs 
+// so disk caching and scheduling noise don't skew the scaling. Only the 
+// parse and the join into meshes are timed, not material libraries, bounds 
+// or packing.
+static bool BenchmarkParse(const char* a_pFilename, float a_scale)
+{
+	unsigned long long fileSize = 0;
+	long long modifiedTime = 0;
+
+	if (!OBJMappedFile::GetFileStamp(a_pFilename, fileSize, modifiedTime))
+	{
+		return false;
+	}
+
+	const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	const unsigned int runs = 3;
+	const double megabyte = 1024.0 * 1024.0;
+	// Fastest time of each thread count the file was actually parsed on.
+	std::vector<std::pair<unsigned int, double>> bestTimes;
+
+	for (unsigned int threads = 1; threads <= maxThreads; ++threads)
+	{
+		double bestTime = 0.0;
+		unsigned int usedThreads = 0;
+
+		for (unsigned int run = 0; run < runs; ++run)
+		{
+			OBJModel model(a_pFilename, a_scale);
+			model.SetUseCache(false);
+			model.SetParseThreadCount(threads);
+
+			if (!model.Load(a_pFilename))
+			{
+				return false;
+			}
+
+			const OBJModel::ParseStatistics& statistics = model.GetParseStatistics();
+			const double parseTime = statistics.parseTime - statistics.materialLibraryTime;
+			bestTime = run == 0 ? parseTime : std::min(bestTime, parseTime);
+			usedThreads = statistics.threadCount;
+		}
+
+		bestTimes.push_back(std::make_pair(usedThreads, bestTime));
+
+		// Small files are split between fewer threads than asked for, more 
+		// threads would only repeat the last row.
+		if (usedThreads < threads)
+		{
+			break;
+		}
+	}
+
+	std::cout << "Parse scaling of " << a_pFilename << " (" << fileSize / megabyte << " MB):" << std::endl;
+
+	for (auto iterator = bestTimes.begin(); iterator != bestTimes.end(); ++iterator)
+	{
+		std::cout << "  " << iterator->first << " thread(s): " <<
+			iterator->second * 1000.0 << " ms, " <<
+			fileSize / megabyte / iterator->second << " MB/s, " <<
+			bestTimes.front().second / iterator->second << "x" << std::endl;
+	}
+
+	if (bestTimes.back().first < maxThreads)
+	{
+		std::cout << "  The file is too small to split between more than " << bestTimes.back().first <<
+			" thread(s)." << std::endl;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Offline tool that writes the binary caches for OBJ models and their textures, so the first launch of the application doesn't 
+/// have to parse models, decode images or build mips. Small textures are packed into the same atlases the application 
+/// packs, and only the atlases are baked for them.
+/// Usage: OBJCacheBaker [-benchmark] [-scale value] model.obj [[-scale value] model.obj ...]
+/// The scale must match the one the application loads the model with, it applies to every model after it.
+/// With -benchmark nothing is baked, each model is parsed from its source on 1 up to every hardware thread, or as many as 
+/// the file can be split between, and the parse time and throughput of each thread count are logged.
+/// </summary>
+int main(int a_argumentCount, char* a_arguments[])
+{
+	if (a_argumentCount < 2)
+	{
+		std::cout << "Usage: OBJCacheBaker [-benchmark] [-scale value] model.obj [[-scale value] model.obj ...]" <<
+			std::endl;
+		return 1;
+	}
+
+	float scale = 1.0f;
+	bool bBenchmark = false;
+	unsigned int failures = 0;
+	// Materials and models often share textures, each cache is only baked 
+	// once.
+	std::set<std::string> bakedCaches;
+
+	for (int i = 1; i < a_argumentCount; ++i)
+	{
+		if (strcmp(a_arguments[i], "-scale") == 0 && i + 1 < a_argumentCount)
+		{
+			scale = (float)atof(a_arguments[++i]);
+			continue;
+		}
+
+		if (strcmp(a_arguments[i], "-benchmark") == 0)
+		{
+			bBenchmark = true;
+			continue;
+		}
+
+		const char* pFilename = a_arguments[i];
+
+		if (bBenchmark)
+		{
+			if (!BenchmarkParse(pFilename, scale))
+			{
+				std::cout << "Error: Failed to load: " << pFilename << std::endl;
+				++failures;
+			}
+
+			continue;
+		}
+
+		OBJModel model(pFilename, scale);
+		// Always parse the source, an existing cache may be stale.
+		model.SetUseCache(false);
+		std::string cacheFilename = OBJModel::GetCacheFileName(pFilename);
+
+		if (model.Load(pFilename) && model.SaveCache(cacheFilename.c_str()))
+		{
+			std::cout << "Baked: " << cacheFilename << std::endl;
+		}
+		else
+		{
+			std::cout << "Error: Failed to bake: " << pFilename << std::endl;
+			++failures;
+			continue;
+		}
+
+		// Atlases are baked like any texture, from their manifest, and the 
+		// textures they hold aren't baked on their own.
+		std::vector<std::pair<std::string, OBJMaterial::TEXTURE_TYPES>> textures;
+
+		for (unsigned int texture = 0; texture < OBJMaterial::TEXTURE_TYPES_COUNT; ++texture)
+		{
+			const OBJMaterial::TEXTURE_TYPES type = (OBJMaterial::TEXTURE_TYPES)texture;
+			std::vector<std::string> typeFilenames;
+			TextureAtlas::GetModelTextures(&model, type, typeFilenames);
+			TextureAtlas atlas;
+			const std::string atlasFilename = TextureAtlas::GetAtlasFileName(pFilename, type);
+
+			if (atlas.Pack(typeFilenames) > 0 && atlas.Save(atlasFilename.c_str()))
+			{
+				for (auto iterator = typeFilenames.begin(); iterator != typeFilenames.end(); ++iterator)
+				{
+					if (atlas.FindRegion(*iterator) != nullptr)
+					{
+						bakedCaches.insert(TextureCache::GetCacheFileName(iterator->c_str(),
+							type == OBJMaterial::TEXTURE_TYPES_NORMAL));
+					}
+				}
+
+				typeFilenames.push_back(atlasFilename);
+			}
+
+			for (auto iterator = typeFilenames.begin(); iterator != typeFilenames.end(); ++iterator)
+			{
+				if (bakedCaches.insert(TextureCache::GetCacheFileName(iterator->c_str(),
+					type == OBJMaterial::TEXTURE_TYPES_NORMAL)).second)
+				{
+					textures.push_back(std::make_pair(*iterator, type));
+				}
+			}
+		}
+
+		for (auto iterator = textures.begin(); iterator != textures.end(); ++iterator)
+		{
+			const std::string& textureFilename = iterator->first;
+			// Every hardware thread compresses each texture's blocks.
+			const unsigned int compressThreads = 0;
+			TextureCache textureCache;
+			const bool bNormalMap = iterator->second == OBJMaterial::TEXTURE_TYPES_NORMAL;
+			std::string textureCacheFilename = TextureCache::GetCacheFileName(textureFilename.c_str(), bNormalMap);
+			bool bBaked = textureCache.Decode(textureFilename.c_str());
+
+			if (bBaked)
+			{
+				textureCache.Compress(bNormalMap, compressThreads);
+				bBaked = textureCache.Save(textureCacheFilename.c_str(), textureFilename.c_str());
+			}
+
+			if (bBaked)
+			{
+				std::cout << "Baked: " << textureCacheFilename << std::endl;
+			}
+			else
+			{
+				std::cout << "Error: Failed to bake: " << textureFilename << std::endl;
+				++failures;
+			}
+		}
+	}
+
+	return failures == 0 ? 0 : 1;
+}
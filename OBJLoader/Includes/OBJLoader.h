@@ -73,6 +73,44 @@ inline bool OBJVertex::operator < (const OBJVertex& a_rhs) const
 	return memcmp(this, &a_rhs, sizeof(OBJVertex)) < 0;
 }
 
+/// <summary>
+/// Compact 20 byte alternative to OBJVertex. The position keeps full precision, the normal is packed into signed 10:10:10:2 and the UV coordinate into two half floats.
+/// </summary>
+class OBJPackedVertex
+{
+public:
+	enum OFFSETS
+	{
+		OFFSETS_POSITION_OFFSET = 0,
+		OFFSETS_NORMAL_OFFSET = OFFSETS_POSITION_OFFSET + sizeof(glm::vec3),
+		OFFSETS_UV_COORDINATE_OFFSET = OFFSETS_NORMAL_OFFSET + sizeof(unsigned int),
+		OFFSETS_COUNT
+	};
+
+	OBJPackedVertex();
+	explicit OBJPackedVertex(const OBJVertex& a_vertex);
+	~OBJPackedVertex();
+
+	// Expands back to a full vertex, the normal comes back unit length.
+	OBJVertex Unpack() const;
+	const glm::vec3 GetPosition() const;
+
+private:
+	glm::vec3 m_position;
+	// Matches GL_INT_2_10_10_10_REV, w is always zero.
+	unsigned int m_normal;
+	// Matches two GL_HALF_FLOAT values, u is in the low half.
+	unsigned int m_uvCoordinate;
+};
+
+inline OBJPackedVertex::OBJPackedVertex() : m_position(0, 0, 0),
+	m_normal(0),
+	m_uvCoordinate(0)
+{}
+
+inline OBJPackedVertex::~OBJPackedVertex()
+{}
+
 /// <summary>
 /// Stores an OBJ models material data. Materials have properties such as lights, textures and roughness.
 /// </summary>
@@ -143,27 +181,113 @@ public:
 	void SetVertices(std::vector<OBJVertex> a_vertices);
 	void SetIndices(std::vector<unsigned int> a_indices);
 	void SetMaterial(OBJMaterial* a_material);
+	// Converts the vertices to OBJPackedVertex and frees the full precision 
+	// copies. Reports the largest normal error in degrees and UV error.
+	void PackVertices(float& a_maxNormalError, float& a_maxUVError);
+	bool IsPacked() const;
+	// Fits an axis aligned box and a sphere around the vertex positions, and 
+	// measures how much of the world a unit of UV spans.
+	void CalculateBounds();
+	const glm::vec3& GetBoundsMin() const;
+	const glm::vec3& GetBoundsMax() const;
+	// Centre in xyz and radius in w, in model space.
+	const glm::vec4& GetBoundingSphere() const;
+	// Model space units one unit of UV spans, averaged over the triangles' 
+	// areas. 0 when the mesh has no UV area.
+	float GetUVDensity() const;
 	const std::string GetName() const;
 	std::vector<OBJVertex>* GetVertices();
+	std::vector<OBJPackedVertex>* GetPackedVertices();
 	std::vector<unsigned int>* GetIndices();
 	OBJMaterial* GetMaterial();
 
 private:
 	std::string m_name;
 	std::vector<OBJVertex> m_vertices;
+	std::vector<OBJPackedVertex> m_packedVertices;
 	std::vector<unsigned int> m_indices;
 	OBJMaterial* m_poMaterial;
+	glm::vec3 m_boundsMin;
+	glm::vec3 m_boundsMax;
+	glm::vec4 m_boundingSphere;
+	float m_fUVDensity;
 };
 
 inline OBJMesh::OBJMesh() : m_name(),
 	m_vertices(),
+	m_packedVertices(),
 	m_indices(),
-	m_poMaterial(nullptr)
+	m_poMaterial(nullptr),
+	m_boundsMin(0.f),
+	m_boundsMax(0.f),
+	m_boundingSphere(0.f),
+	m_fUVDensity(0.f)
 {}
 
 inline OBJMesh::~OBJMesh()
 {}
 
+/// <summary>
+/// Read-only view of a whole file's bytes. The file is memory mapped where the platform allows it, otherwise it's read into a single buffer.
+/// </summary>
+class OBJMappedFile
+{
+public:
+	OBJMappedFile();
+	~OBJMappedFile();
+
+	// Gets a file's size and last modified time, without opening it where 
+	// the platform allows. The time is 0 if the platform can't provide it.
+	static bool GetFileStamp(const char* a_filename,
+		unsigned long long& a_size,
+		long long& a_modifiedTime);
+	// Whether the file is on storage that can't be written, such as the NX 
+	// ROM mount.
+	static bool IsReadOnlyPath(const char* a_filename);
+
+	bool Open(const char* a_filename);
+	void Close();
+	bool IsMapped() const;
+	const char* GetData() const;
+	size_t GetSize() const;
+	// 64-bit XXH64 hash of the file's contents.
+	unsigned long long GetHash() const;
+	static unsigned long long Hash(const void* a_pData, size_t a_size);
+
+private:
+	// Mapping can't be shared, the view would be unmapped twice.
+	OBJMappedFile(const OBJMappedFile&);
+	OBJMappedFile& operator = (const OBJMappedFile&);
+
+	bool Map(const char* a_filename);
+	bool Read(const char* a_filename);
+
+	bool m_bMapped;
+	const char* m_pData;
+	size_t m_size;
+	// Fallback storage used when the file couldn't be mapped.
+	std::vector<char> m_buffer;
+#ifdef _WIN32
+	void* m_pFileHandle;
+	void* m_pMappingHandle;
+#endif // _WIN32.
+};
+
+inline OBJMappedFile::OBJMappedFile() : m_bMapped(false),
+	m_pData(nullptr),
+	m_size(0),
+	m_buffer()
+#ifdef _WIN32
+	, m_pFileHandle(nullptr),
+	m_pMappingHandle(nullptr)
+#endif // _WIN32.
+{}
+
+inline OBJMappedFile::~OBJMappedFile()
+{
+	Close();
+}
+
 /// <summary>
 /// Use this class to create OBJ models inside the application.
 /// Makes use of vertex, material and mesh OBJ classes.
@@ -171,6 +295,26 @@ inline OBJMesh::~OBJMesh()
 class OBJModel
 {
 public:
+	enum VERTEX_FORMATS
+	{
+		// Meshes keep OBJVertex, 40 bytes per vertex.
+		VERTEX_FORMATS_FULL = 0,
+		// Meshes are converted to OBJPackedVertex, 20 bytes per vertex.
+		VERTEX_FORMATS_PACKED,
+		VERTEX_FORMATS_COUNT
+	};
+
+	typedef struct ParseStatistics
+	{
+		// Threads the last parse ran on, fewer than asked for when the file 
+		// is too small to split between them.
+		unsigned int threadCount;
+		// Seconds spent parsing the chunks and joining them into meshes, 
+		// and of that the seconds spent loading material libraries.
+		double parseTime;
+		double materialLibraryTime;
+	} ParseStatistics;
+
 	OBJModel();
 	OBJModel(std::string a_filepath,
 		const float a_scale);
@@ -179,10 +323,24 @@ public:
 	bool Load(const char* a_filename);
 	// Unloads and frees memory.
 	void Unload();
+	// Sets how many threads Load parses with. 0 uses every hardware thread
+	// and 1 parses serially. Small files always parse on one thread.
+	void SetParseThreadCount(unsigned int a_threadCount);
+	// Timing of the last Load that parsed the OBJ text, zeroed when it was 
+	// loaded from its cache.
+	const ParseStatistics& GetParseStatistics() const;
+	// Load reads and writes a binary cache next to the OBJ file when enabled,
+	// so the text is only parsed once. Enabled by default.
+	void SetUseCache(bool a_useCache);
+	bool LoadCache(const char* a_cacheFilename);
+	bool SaveCache(const char* a_cacheFilename) const;
+	static std::string GetCacheFileName(const char* a_filename);
+	// Chooses the vertex layout meshes are left in by the next Load.
+	void SetVertexFormat(VERTEX_FORMATS a_vertexFormat);
+	VERTEX_FORMATS GetVertexFormat() const;
 	const char* GetFilePath() const;
 	const unsigned int GetMeshCount() const;
 	const unsigned int GetMaterialCount() const;
-	const glm::mat4& GetWorldMatrix() const;
 	OBJMesh* GetMeshByIndex(unsigned int a_index);
 	OBJMaterial* GetMaterialByName(const char* a_name);
 	OBJMaterial* GetMaterialByIndex(unsigned int a_index);
@@ -193,30 +351,119 @@ private:
 		unsigned int vertex;
 		unsigned int uvCoordinate;
 		unsigned int normalVertex;
+
+		bool operator == (const OBJFaceTriplet& a_rhs) const
+		{
+			return vertex == a_rhs.vertex &&
+				uvCoordinate == a_rhs.uvCoordinate &&
+				normalVertex == a_rhs.normalVertex;
+		}
 	} objFaceTriplet;
 
-	std::string LineType(const std::string& a_in);
-	std::string LineData(const std::string& a_in);
-	glm::vec4 ProcessVectorString(const std::string a_data);
-	std::vector<std::string> SplitStringAtCharacter(std::string a_data, char a_character);
+	// Hashes a face triplet so identical corners can share one vertex.
+	typedef struct OBJFaceTripletHash
+	{
+		size_t operator () (const OBJFaceTriplet& a_triplet) const
+		{
+			size_t hash = a_triplet.vertex;
+			hash = hash * 2654435761u ^ a_triplet.uvCoordinate;
+			hash = hash * 2654435761u ^ a_triplet.normalVertex;
+			return hash;
+		}
+	} OBJFaceTripletHash;
+
+	// Line types that must be replayed in file order after parsing.
+	enum RECORD_TYPES
+	{
+		RECORD_TYPES_FACE = 0,
+		RECORD_TYPES_GROUP,
+		RECORD_TYPES_MATERIAL_LIBRARY,
+		RECORD_TYPES_USE_MATERIAL,
+		RECORD_TYPES_COMMENT,
+		RECORD_TYPES_COUNT
+	};
+
+	typedef struct OBJRecord
+	{
+		RECORD_TYPES type;
+		// Faces store their first corner and corner count, other records 
+		// store the offset and length of their line data within the chunk.
+		unsigned int start;
+		unsigned int count;
+		// Amount of each vertex attribute the chunk had read before this 
+		// record, used to resolve indices into the file's global index space.
+		unsigned int vertexCount;
+		unsigned int uvCount;
+		unsigned int normalCount;
+	} OBJRecord;
+
+	// Everything parsed from one line aligned section of an OBJ file.
+	typedef struct OBJParseChunk
+	{
+		const char* pBegin;
+		const char* pEnd;
+		std::vector<glm::vec4> vertexData;
+		std::vector<glm::vec4> normalData;
+		std::vector<glm::vec2> uvData;
+		std::vector<OBJFaceTriplet> corners;
+		std::vector<OBJRecord> records;
+	} OBJParseChunk;
+
+	// Parses vertex data and faces, safe to run on several chunks at once.
+	void ParseChunk(OBJParseChunk& a_chunk) const;
+	// Joins parsed chunks into meshes, in file order.
+	void BuildMeshes(std::vector<OBJParseChunk>& a_chunks);
+	// Fits bounding volumes around every mesh.
+	void CalculateMeshBounds();
+	// Converts every mesh to the packed vertex format if it was requested.
+	void PackMeshes();
 	void LoadMaterialLibrary(std::string a_mtllib);
 
-	OBJFaceTriplet ProcessTriplet(std::string a_triplet);
+	// Tokenizer helpers. These walk a contiguous character buffer and never
+	// allocate, each returns the position parsing stopped at.
+	static const char* SkipWhitespace(const char* a_pCursor, const char* a_pEnd);
+	static const char* SkipToken(const char* a_pCursor, const char* a_pEnd);
+	static const char* TrimLineEnd(const char* a_pBegin, const char* a_pEnd);
+	static bool TokenEquals(const char* a_pToken,
+		size_t a_length,
+		const char* a_pKeyword);
+	// Returns a_pCursor unchanged if no number could be read.
+	static const char* ParseFloat(const char* a_pCursor,
+		const char* a_pEnd,
+		float& a_value);
+	// Returns a_pCursor unchanged if no number could be read.
+	static const char* ParseUnsignedInteger(const char* a_pCursor,
+		const char* a_pEnd,
+		unsigned int& a_value);
+	static glm::vec4 ProcessVector(const char* a_pCursor, const char* a_pEnd);
+	static const char* ProcessTriplet(const char* a_pCursor,
+		const char* a_pEnd,
+		OBJFaceTriplet& a_triplet);
 
+	bool m_bUseCache;
 	float m_fModelScale;
+	unsigned int m_uiParseThreadCount;
+	ParseStatistics m_parseStatistics;
+	VERTEX_FORMATS m_vertexFormat;
 	OBJMaterial* m_pCurrentMaterial;
 	std::vector<OBJMesh*> m_meshes;
 	std::vector<OBJMaterial*> m_materials;
+	// The OBJ file's name and any material libraries it used, relative to 
+	// m_filePath. The cache is rebuilt if any of these change.
+	std::vector<std::string> m_sourceFiles;
 	std::string m_filePath;
-	glm::mat4 m_worldMatrix;
 };
 
-inline OBJModel::OBJModel() : m_fModelScale(1.0f),
+inline OBJModel::OBJModel() : m_bUseCache(true),
+	m_fModelScale(1.0f),
+	m_uiParseThreadCount(0),
+	m_parseStatistics(),
+	m_vertexFormat(VERTEX_FORMATS_FULL),
 	m_pCurrentMaterial(nullptr),
 	m_meshes(),
 	m_materials(),
-	m_filePath(),
-	m_worldMatrix(glm::mat4(1.0f))
+	m_sourceFiles(),
+	m_filePath()
 {}
 
 inline OBJModel::~OBJModel()
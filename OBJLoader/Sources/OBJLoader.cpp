@@ -5,15 +5,46 @@
 //////////////////////////////
 
 #include "OBJLoader.h" // File's header.
+#include <GLM/gtc/packing.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX.
+#include <windows.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define OBJ_MAPPED_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // _WIN32 / __unix__ || __APPLE__.
 
 OBJModel::OBJModel(std::string a_filepath,
-	const float a_scale) : m_pCurrentMaterial(nullptr),
+	const float a_scale) : m_bUseCache(true),
+	m_uiParseThreadCount(0),
+	m_parseStatistics(),
+	m_vertexFormat(VERTEX_FORMATS_FULL),
+	m_pCurrentMaterial(nullptr),
 	m_meshes(),
 	m_materials(),
-	m_worldMatrix(glm::mat4(1.0f))
+	m_sourceFiles()
 {
 	m_filePath = a_filepath;
 	m_fModelScale = a_scale;
@@ -49,6 +80,35 @@ const glm::vec2 OBJVertex::GetUVCoordinate() const
 	return m_uvCoordinate;
 }
 
+OBJPackedVertex::OBJPackedVertex(const OBJVertex& a_vertex) : m_position(a_vertex.GetPosition()),
+	m_normal(0),
+	m_uvCoordinate(glm::packHalf2x16(a_vertex.GetUVCoordinate()))
+{
+	glm::vec3 normal = glm::vec3(a_vertex.GetNormal());
+	float length = glm::length(normal);
+
+	// Missing normals stay zero, everything else is stored unit length so 
+	// the 10 bit components use their full range.
+	if (length > 0.f)
+	{
+		m_normal = glm::packSnorm3x10_1x2(glm::vec4(normal / length, 0.f));
+	}
+}
+
+OBJVertex OBJPackedVertex::Unpack() const
+{
+	OBJVertex vertex;
+	vertex.SetPosition(glm::vec4(m_position, 1.f));
+	vertex.SetNormal(glm::unpackSnorm3x10_1x2(m_normal));
+	vertex.SetUVCoordinate(glm::unpackHalf2x16(m_uvCoordinate));
+	return vertex;
+}
+
+const glm::vec3 OBJPackedVertex::GetPosition() const
+{
+	return m_position;
+}
+
 OBJMaterial::OBJMaterial() : m_uiTextureIDs(),
 	m_name(),
 	m_textureFileNames(),
@@ -182,646 +242,1912 @@ void OBJMesh::SetMaterial(OBJMaterial* a_material)
 	m_poMaterial = a_material;
 }
 
-const std::string OBJMesh::GetName() const
+// Converts the vertices to OBJPackedVertex and frees the full precision 
+// copies. Reports the largest normal error in degrees and UV error.
+void OBJMesh::PackVertices(float& a_maxNormalError, float& a_maxUVError)
 {
-	return m_name;
-}
+	a_maxNormalError = 0.f;
+	a_maxUVError = 0.f;
+	m_packedVertices.clear();
+	m_packedVertices.reserve(m_vertices.size());
 
-std::vector<OBJVertex>* OBJMesh::GetVertices()
-{
-	return &m_vertices;
-}
+	for (auto iterator = m_vertices.begin(); iterator != m_vertices.end(); ++iterator)
+	{
+		m_packedVertices.push_back(OBJPackedVertex(*iterator));
+		OBJVertex unpacked = m_packedVertices.back().Unpack();
+		glm::vec3 normal = glm::vec3(iterator->GetNormal());
 
-std::vector<unsigned int>* OBJMesh::GetIndices()
-{
-	return &m_indices;
+		if (glm::length(normal) > 0.f)
+		{
+			float cosine = glm::dot(glm::normalize(normal),
+				glm::normalize(glm::vec3(unpacked.GetNormal())));
+			a_maxNormalError = std::max(a_maxNormalError,
+				glm::degrees(std::acos(glm::clamp(cosine, -1.f, 1.f))));
+		}
+
+		glm::vec2 uvError = glm::abs(iterator->GetUVCoordinate() - unpacked.GetUVCoordinate());
+		a_maxUVError = std::max(a_maxUVError, std::max(uvError.x, uvError.y));
+	}
+
+	std::vector<OBJVertex>().swap(m_vertices);
 }
 
-OBJMaterial* OBJMesh::GetMaterial()
+bool OBJMesh::IsPacked() const
 {
-	return m_poMaterial;
+	return !m_packedVertices.empty();
 }
 
-bool OBJModel::Load(const char* a_filename)
+// Fits an axis aligned box and a sphere around the vertex positions, and 
+// measures how much of the world a unit of UV spans.
+void OBJMesh::CalculateBounds()
 {
-	std::cout << "Attempting to open file: " << a_filename << std::endl;
-	// Get an fstream to read in the file data.
-	std::fstream file;
-	file.open(a_filename, std::ios_base::in | std::ios_base::binary);
+	const size_t vertexCount = IsPacked() ? m_packedVertices.size() : m_vertices.size();
 
-	// Test to see if the file has opened correctly.
-	if (file.is_open())
+	if (vertexCount == 0)
 	{
-		std::cout << "Successfully Opened." << std::endl;
-		// Get file path information.
-		std::string filePath = a_filename;
-		size_t pathEnd = filePath.find_last_of("/\\");
+		m_boundsMin = m_boundsMax = glm::vec3(0.f);
+		m_boundingSphere = glm::vec4(0.f);
+		m_fUVDensity = 0.f;
+		return;
+	}
 
-		if (pathEnd != std::string::npos)
-		{
-			filePath = filePath.substr(0, pathEnd + 1);
-		}
-		else
-		{
-			filePath = "";
-		}
+	m_boundsMin = glm::vec3(std::numeric_limits<float>::max());
+	m_boundsMax = glm::vec3(-std::numeric_limits<float>::max());
 
-		m_filePath = filePath;
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		glm::vec3 position = IsPacked() ? m_packedVertices[i].GetPosition() : glm::vec3(m_vertices[i].GetPosition());
+		m_boundsMin = glm::min(m_boundsMin, position);
+		m_boundsMax = glm::max(m_boundsMax, position);
+	}
 
-		// Success file has been opened, verify contents of file.
-		file.ignore(std::numeric_limits<std::streamsize>::max());
-		std::streamsize fileSize = file.gcount();
-		file.clear();
-		file.seekg(0, std::ios_base::beg);
+	// Centring on the box and measuring the furthest vertex gives a tighter 
+	// sphere than the box's half diagonal.
+	glm::vec3 centre = (m_boundsMin + m_boundsMax) * 0.5f;
+	float radiusSquared = 0.f;
 
-		if (fileSize == 0)
-		{
-			std::cout << "File contains no data, closing file." << std::endl;
-			file.close();
-		}
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		glm::vec3 position = IsPacked() ? m_packedVertices[i].GetPosition() : glm::vec3(m_vertices[i].GetPosition());
+		glm::vec3 offset = position - centre;
+		radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+	}
 
-		const unsigned int kilobyte = 1024;
-		std::cout << "File size: " << fileSize / kilobyte << " KB" << std::endl;
+	m_boundingSphere = glm::vec4(centre, std::sqrt(radiusSquared));
+	// Texture streaming scales a mesh's size on screen by this to find the 
+	// texels its textures need.
+	double worldArea = 0.0;
+	double uvArea = 0.0;
 
-		OBJMesh* pCurrentMesh = nullptr;
-		std::string fileLine;
-		std::vector<glm::vec4> vertexData;
-		std::vector<glm::vec4> normalData;
-		std::vector<glm::vec2> uvData;
-		// Store out material is a string as face data is not generated prior 
-		// to material assignment and may not have a mesh.
-		OBJMaterial* pCurrentMtl = nullptr;
+	for (size_t i = 0; i + 2 < m_indices.size(); i += 3)
+	{
+		glm::vec3 positions[3];
+		glm::vec2 uvCoordinates[3];
 
-		// Set up reading in chunks of a file at a time.
-		while (!file.eof())
+		for (unsigned int corner = 0; corner < 3; ++corner)
 		{
-			if (std::getline(file, fileLine))
-			{
-				if (fileLine.size() > 0)
-				{
-					std::string dataType = LineType(fileLine);
+			const OBJVertex vertex = IsPacked() ? m_packedVertices[m_indices[i + corner]].Unpack() :
+				m_vertices[m_indices[i + corner]];
+			positions[corner] = glm::vec3(vertex.GetPosition());
+			uvCoordinates[corner] = vertex.GetUVCoordinate();
+		}
 
-					// If dataType has a 0 length then skip all tests and 
-					// continue to next line.
-					if (dataType.length() == 0)
-					{
-						continue;
-					}
+		const glm::vec2 uvEdgeA = uvCoordinates[1] - uvCoordinates[0];
+		const glm::vec2 uvEdgeB = uvCoordinates[2] - uvCoordinates[0];
+		worldArea += 0.5 * glm::length(glm::cross(positions[1] - positions[0], positions[2] - positions[0]));
+		uvArea += 0.5 * std::abs(uvEdgeA.x * uvEdgeB.y - uvEdgeA.y * uvEdgeB.x);
+	}
 
-					std::string data = LineData(fileLine);
+	m_fUVDensity = uvArea > 0.0 ? (float)std::sqrt(worldArea / uvArea) : 0.f;
+}
 
-					if (dataType == "#")
-					{
-						// This is a comment line.
-						std::cout << data << std::endl;
-						continue;
-					}
+const glm::vec3& OBJMesh::GetBoundsMin() const
+{
+	return m_boundsMin;
+}
 
-					if (dataType == "mtllib")
-					{
-						std::cout << "Material File: " << data << std::endl;
-						// Load in material fle so that materials can be used as required.
-						LoadMaterialLibrary(data);
-						continue;
-					}
+const glm::vec3& OBJMesh::GetBoundsMax() const
+{
+	return m_boundsMax;
+}
 
-					if (dataType == "g" || dataType == "o")
-					{
-						std::cout << "OBJ Group Found: " << data << std::endl;
-						
-						// We can use group tags to split our model into 
-						// smaller mesh components.
-						if (pCurrentMesh != nullptr)
-						{
-							m_meshes.push_back(pCurrentMesh);
-						}
+// Centre in xyz and radius in w, in model space.
+const glm::vec4& OBJMesh::GetBoundingSphere() const
+{
+	return m_boundingSphere;
+}
 
-						pCurrentMesh = new OBJMesh();
-						pCurrentMesh->SetName(data);
+// Model space units one unit of UV spans, averaged over the triangles' areas. 
+// 0 when the mesh has no UV area.
+float OBJMesh::GetUVDensity() const
+{
+	return m_fUVDensity;
+}
 
-						// If we have a material name.
-						if (pCurrentMtl)
-						{
-							pCurrentMesh->SetMaterial(pCurrentMtl);
-							pCurrentMtl = nullptr;
-						}
+const std::string OBJMesh::GetName() const
+{
+	return m_name;
+}
 
-						continue;
-					}
+std::vector<OBJVertex>* OBJMesh::GetVertices()
+{
+	return &m_vertices;
+}
 
-					if (dataType == "v") // Data is a vector.
-					{
-						glm::vec4 vertex = ProcessVectorString(data);
-						// Multiply by passed in vector to allow scaling of the model.
-						vertex *= m_fModelScale;
-						// As this is positional data ensure the w component 
-						// is set to 1.0f;
-						vertex.w = 1.f;
-						vertexData.push_back(vertex);
-						continue;
-					}
+std::vector<OBJPackedVertex>* OBJMesh::GetPackedVertices()
+{
+	return &m_packedVertices;
+}
 
-					if (dataType == "vt") // Data is a UV coordinate.
-					{
-						glm::vec4 uvCoordinateV4 = ProcessVectorString(data);
-						glm::vec2 uvCoordinate =
-							glm::vec2(uvCoordinateV4.x, uvCoordinateV4.y);
-						uvData.push_back(uvCoordinate);
-						continue;
-					}
+std::vector<unsigned int>* OBJMesh::GetIndices()
+{
+	return &m_indices;
+}
 
-					if (dataType == "vn") // Data is a normal.
-					{
-						glm::vec4 normal = ProcessVectorString(data);
-						normal.w = 0.f;
-						normalData.push_back(normal);
-						continue;
-					}
+OBJMaterial* OBJMesh::GetMaterial()
+{
+	return m_poMaterial;
+}
 
-					if (dataType == "f") // Data is a face.
-					{
-						// We have entered processing faces without having 
-						// hit a 'o' or 'g' tag.
-						if (!pCurrentMesh)
-						{
-							pCurrentMesh = new OBJMesh();
-							
-							if (pCurrentMtl)
-							{
-								pCurrentMesh->SetMaterial(pCurrentMtl);
-								pCurrentMtl = nullptr;
-							}
-						}
+bool OBJMappedFile::GetFileStamp(const char* a_filename,
+	unsigned long long& a_size,
+	long long& a_modifiedTime)
+{
+#ifdef _WIN32
+	struct _stat64 fileStatus;
 
-						// Face consists of 3 -> more vertices split at ' ' 
-						// then at '/' character.
-						std::vector<std::string> faceData =	SplitStringAtCharacter(data, ' ');
-						unsigned int currentIndex = (unsigned int)pCurrentMesh->GetVertices()->size();
+	if (_stat64(a_filename, &fileStatus) != 0)
+	{
+		return false;
+	}
 
-						for (auto iterator = faceData.begin();
-							iterator != faceData.end();
-							++iterator)
-						{
-							// Process face triplet.
-							OBJFaceTriplet triplet = ProcessTriplet(*iterator);
-							// Triplet processed new set vertex data from 
-							// position/normal/texture data.
-							OBJVertex currentVertex;
-							currentVertex.SetPosition(vertexData[triplet.vertex - 1]);
-
-							if (triplet.normalVertex != 0)
-							{
-								currentVertex.SetNormal(normalData[triplet.normalVertex - 1]);
-							}
-
-							if (triplet.uvCoordinate != 0)
-							{
-								currentVertex.SetUVCoordinate(uvData[triplet.uvCoordinate - 1]);
-							}
-
-							pCurrentMesh->GetVertices()->push_back(currentVertex);
-						}
+	a_size = (unsigned long long)fileStatus.st_size;
+	a_modifiedTime = (long long)fileStatus.st_mtime;
+	return true;
+#elif defined(OBJ_MAPPED_FILE_POSIX)
+	struct stat fileStatus;
 
-						bool calculateNormals = normalData.empty();
+	if (stat(a_filename, &fileStatus) != 0)
+	{
+		return false;
+	}
 
-						// All face information for the tri/quad/fan have been collected.
-						// Time to index these into the current mesh.
-						for (unsigned int offset = 1; offset < (faceData.size() - 1); ++offset)
-						{
-							pCurrentMesh->GetIndices()->push_back(currentIndex);
-							pCurrentMesh->GetIndices()->push_back(currentIndex + offset);
-							pCurrentMesh->GetIndices()->push_back(currentIndex + offset + 1);
-
-							// Test to see if the OBJ file contains normal data, 
-							// if normalData is empty then there are no normals.
-							if (calculateNormals)
-							{
-								unsigned int index = currentIndex;
-								glm::vec4 normal = pCurrentMesh->CalculateFaceNormal(index,
-									index + offset,
-									index + offset + 1);
-								(*pCurrentMesh->GetVertices())[index].SetNormal(normal);
-								index += offset;
-								(*pCurrentMesh->GetVertices())[index].SetNormal(normal);
-								index += 1;
-								(*pCurrentMesh->GetVertices())[index].SetNormal(normal);
-							}
-						}
+	a_size = (unsigned long long)fileStatus.st_size;
+	a_modifiedTime = (long long)fileStatus.st_mtime;
+	return true;
+#else
+	// Other platforms only get the size, without a modified time the file's 
+	// contents are compared instead.
+	std::fstream file;
+	file.open(a_filename, std::ios_base::in | std::ios_base::binary);
 
-						continue;
-					}
+	if (!file.is_open())
+	{
+		return false;
+	}
 
-					if (dataType == "usemtl")
-					{
-						// We have a material to use on the current mesh.
-						OBJMaterial* pMtl = GetMaterialByName(data.c_str());
+	file.seekg(0, std::ios_base::end);
+	const std::streamsize fileSize = file.tellg();
+	file.close();
 
-						if (pMtl)
-						{
-							pCurrentMtl = pMtl;
+	if (fileSize < 0)
+	{
+		return false;
+	}
 
-							if (pCurrentMesh)
-							{
-								pCurrentMesh->SetMaterial(pCurrentMtl);
-							}
-						}
+	a_size = (unsigned long long)fileSize;
+	a_modifiedTime = 0;
+	return true;
+#endif // _WIN32 / OBJ_MAPPED_FILE_POSIX.
+}
 
-						continue;
-					}
-				}
-			}
-		}
+bool OBJMappedFile::IsReadOnlyPath(const char* a_filename)
+{
+	// The NX ROM mount is packaged with the application and can't be 
+	// written.
+	const char romMount[] = "rom:";
+	return a_filename != nullptr && strncmp(a_filename, romMount, sizeof(romMount) - 1) == 0;
+}
 
-		if (pCurrentMesh)
-		{
-			m_meshes.push_back(pCurrentMesh);
-		}
+bool OBJMappedFile::Open(const char* a_filename)
+{
+	Close();
 
-		file.close();
+	// Fall back to reading the file if the platform can't map it.
+	if (Map(a_filename))
+	{
+		m_bMapped = true;
 		return true;
 	}
 
-	return false;
+	return Read(a_filename);
 }
 
-// Unloads and frees memory.
-void OBJModel::Unload()
+void OBJMappedFile::Close()
 {
-	m_meshes.clear();
+	if (m_bMapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_pData);
+		CloseHandle((HANDLE)m_pMappingHandle);
+		CloseHandle((HANDLE)m_pFileHandle);
+		m_pMappingHandle = nullptr;
+		m_pFileHandle = nullptr;
+#elif defined(OBJ_MAPPED_FILE_POSIX)
+		munmap((void*)m_pData, m_size);
+#endif // _WIN32 / OBJ_MAPPED_FILE_POSIX.
+	}
+
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+	m_bMapped = false;
+	m_pData = nullptr;
+	m_size = 0;
 }
 
-const char* OBJModel::GetFilePath() const
+bool OBJMappedFile::IsMapped() const
 {
-	return m_filePath.c_str();
+	return m_bMapped;
 }
 
-const unsigned int OBJModel::GetMeshCount() const
+const char* OBJMappedFile::GetData() const
 {
-	return (unsigned int)m_meshes.size();
+	return m_pData;
 }
 
-const unsigned int OBJModel::GetMaterialCount() const
+size_t OBJMappedFile::GetSize() const
 {
-	return (unsigned int)m_materials.size();
+	return m_size;
 }
 
-const glm::mat4& OBJModel::GetWorldMatrix() const
+unsigned long long OBJMappedFile::GetHash() const
 {
-	return m_worldMatrix;
+	return Hash(m_pData, m_size);
 }
 
-OBJMesh* OBJModel::GetMeshByIndex(unsigned int a_index)
+unsigned long long OBJMappedFile::Hash(const void* a_pData, size_t a_size)
 {
-	unsigned int meshCount = (unsigned int)m_meshes.size();
+	const unsigned long long prime1 = 11400714785074694791ULL;
+	const unsigned long long prime2 = 14029467366897019727ULL;
+	const unsigned long long prime3 = 1609587929392839161ULL;
+	const unsigned long long prime4 = 9650029242287828579ULL;
+	const unsigned long long prime5 = 2870177450012600261ULL;
+	const unsigned char* pCursor = (const unsigned char*)a_pData;
+	const unsigned char* pEnd = pCursor + a_size;
+	unsigned long long hash = 0;
+
+	auto rotateLeft = [](unsigned long long a_value, int a_bits)
+	{
+		return (a_value << a_bits) | (a_value >> (64 - a_bits));
+	};
+	auto read64 = [](const unsigned char* a_pBytes)
+	{
+		unsigned long long value;
+		memcpy(&value, a_pBytes, sizeof(value));
+		return value;
+	};
+	auto round = [&](unsigned long long a_accumulator, unsigned long long a_input)
+	{
+		a_accumulator += a_input * prime2;
+		a_accumulator = rotateLeft(a_accumulator, 31);
+		return a_accumulator * prime1;
+	};
+	auto mergeRound = [&](unsigned long long a_hash, unsigned long long a_accumulator)
+	{
+		a_hash ^= round(0, a_accumulator);
+		return a_hash * prime1 + prime4;
+	};
 
-	if (meshCount > 0 && a_index < meshCount)
+	// Consume 32 byte stripes with four independent accumulators.
+	if (a_size >= 32)
 	{
-		return m_meshes[a_index];
-	}
+		unsigned long long accumulators[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+		const unsigned char* pLimit = pEnd - 32;
 
-	return nullptr;
-}
+		do
+		{
+			for (int i = 0; i < 4; ++i, pCursor += 8)
+			{
+				accumulators[i] = round(accumulators[i], read64(pCursor));
+			}
+		}
+		while (pCursor <= pLimit);
 
-OBJMaterial* OBJModel::GetMaterialByName(const char* a_name)
-{
-	for (auto iterator = m_materials.begin();
-		iterator != m_materials.end();
-		++iterator)
-	{
-		OBJMaterial* pMaterial = (*iterator);
-		
-		if (pMaterial->GetName() == a_name)
+		hash = rotateLeft(accumulators[0], 1) + rotateLeft(accumulators[1], 7) +
+			rotateLeft(accumulators[2], 12) + rotateLeft(accumulators[3], 18);
+
+		for (int i = 0; i < 4; ++i)
 		{
-			return pMaterial;
+			hash = mergeRound(hash, accumulators[i]);
 		}
 	}
+	else
+	{
+		hash = prime5;
+	}
 
-	return nullptr;
-}
+	hash += (unsigned long long)a_size;
 
-OBJMaterial* OBJModel::GetMaterialByIndex(unsigned int a_index)
-{
-	unsigned int materialCount = (unsigned int)m_materials.size();
-	
-	if (materialCount > 0 && a_index < materialCount)
+	for (; pCursor + 8 <= pEnd; pCursor += 8)
 	{
-		return m_materials[a_index];
+		hash ^= round(0, read64(pCursor));
+		hash = rotateLeft(hash, 27) * prime1 + prime4;
 	}
 
-	return nullptr;
-}
-
-std::string OBJModel::LineType(const std::string& a_in)
-{
-	if (!a_in.empty())
+	if (pCursor + 4 <= pEnd)
 	{
-		// Gets the token part of the line.
-		size_t token_start = a_in.find_first_not_of(" \t");
-		size_t token_end = a_in.find_first_of(" \t", token_start);
+		unsigned int value;
+		memcpy(&value, pCursor, sizeof(value));
+		hash ^= (unsigned long long)value * prime1;
+		hash = rotateLeft(hash, 23) * prime2 + prime3;
+		pCursor += 4;
+	}
 
-		if (token_start != std::string::npos && token_end != std::string::npos)
-		{
-			return a_in.substr(token_start, token_end - token_start);
-		}
-		else if (token_start != std::string::npos)
-		{
-			return a_in.substr(token_start);
-		}
+	for (; pCursor < pEnd; ++pCursor)
+	{
+		hash ^= (*pCursor) * prime5;
+		hash = rotateLeft(hash, 11) * prime1;
 	}
 
-	return "";
+	// Final avalanche.
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+	return hash;
 }
 
-std::string OBJModel::LineData(const std::string& a_in)
+bool OBJMappedFile::Map(const char* a_filename)
 {
-	// Gets the token part of the line.
-	size_t token_start = a_in.find_first_not_of(" \t");
-	size_t token_end = a_in.find_first_of(" \t", token_start);
-	// Get the data part of the line.
-	size_t data_start = a_in.find_first_not_of(" \t", token_end);
-	size_t data_end = a_in.find_last_not_of(" \t\n\r");
+#ifdef _WIN32
+	HANDLE file = CreateFileA(a_filename,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
 
-	if (data_start != std::string::npos && token_end != std::string::npos)
+	// Empty files can't be mapped.
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
 	{
-		return a_in.substr(data_start, data_end - data_start + 1);
+		CloseHandle(file);
+		return false;
 	}
-	else if (data_start != std::string::npos)
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mapping == nullptr)
 	{
-		return a_in.substr(data_start);
+		CloseHandle(file);
+		return false;
 	}
 
-	return "";
-}
+	const void* pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
 
-glm::vec4 OBJModel::ProcessVectorString(const std::string a_data)
-{
-	// Split the line data at each space character and store this as a float 
-	// value within a glm::vec4.
-	std::stringstream iss(a_data);
-	glm::vec4 vectorData = glm::vec4(0.f);
-	int i = 0;
-	
-	for (std::string value; iss>> value; ++i)
+	if (pView == nullptr)
 	{
-		float fValue = std::stof(value);
-		vectorData[i] = fValue;
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
 	}
 
-	return vectorData;
-}
+	m_pFileHandle = file;
+	m_pMappingHandle = mapping;
+	m_pData = (const char*)pView;
+	m_size = (size_t)fileSize.QuadPart;
+	return true;
+#elif defined(OBJ_MAPPED_FILE_POSIX)
+	int file = open(a_filename, O_RDONLY);
 
-std::vector<std::string> OBJModel::SplitStringAtCharacter(std::string a_data, char a_character)
-{
-	std::vector<std::string> lineData;
-	// Split the line data at each space character and store this as float 
-	// value within a glm::vec4.
-	std::stringstream iss(a_data);
-	std::string lineSegment;
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+
+	// Empty files can't be mapped.
+	if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
 
-	while (std::getline(iss, lineSegment, a_character))
+	void* pView = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	// The mapping keeps its own reference to the file.
+	close(file);
+
+	if (pView == MAP_FAILED)
 	{
-		lineData.push_back(lineSegment);
+		return false;
 	}
 
-	return lineData;
+	madvise(pView, (size_t)fileStatus.st_size, MADV_SEQUENTIAL);
+	m_pData = (const char*)pView;
+	m_size = (size_t)fileStatus.st_size;
+	return true;
+#else
+	(void)a_filename;
+	return false;
+#endif // _WIN32 / OBJ_MAPPED_FILE_POSIX.
 }
 
-void OBJModel::LoadMaterialLibrary(std::string a_mtllib)
+bool OBJMappedFile::Read(const char* a_filename)
 {
-	std::string materialFile = m_filePath + a_mtllib;
-	std::cout << "Attempting to load material file: " << materialFile << std::endl;
-	// Get an fstream to read in the file data.
 	std::fstream file;
-	file.open(materialFile, std::ios_base::in | std::ios_base::binary);
+	file.open(a_filename, std::ios_base::in | std::ios_base::binary);
 
-	// Test to see if the file has opened correctly.
-	if (file.is_open())
+	if (!file.is_open())
 	{
-		std::cout << "Material Library Successfully Opened\n";
-		// Verify contents of file.
-		// Attempt to read the highest number of bytes from the file.
-		file.ignore(std::numeric_limits<std::streamsize>::max());
-		// gCount will have reached EDF marker, letting us know number of bytes.
-		std::streamsize fileSize = file.gcount();
-		// Clear EDF marker from being read.
-		file.clear();
-		// Seek back to the beginning of the file.
-		file.seekg(0, std::ios_base::beg);
+		return false;
+	}
 
-		// If our file has no data close the file and return early.
-		if (fileSize == 0)
-		{
-			std::cout << "File contains no data, closing file.\n";
-			file.close();
-			return;
-		}
+	// Read the whole file with a single call.
+	file.seekg(0, std::ios_base::end);
+	std::streamsize fileSize = file.tellg();
+	file.seekg(0, std::ios_base::beg);
 
-		const unsigned int kilobyte = 1024;
-		std::cout << "Material File Size: " << fileSize / kilobyte << " KB" << std::endl;
-		// Stores file data as its read line by line.
-		std::string fileLine;
-		OBJMaterial* pCurrentMaterial = nullptr;
+	if (fileSize > 0)
+	{
+		m_buffer.resize((size_t)fileSize);
+		file.read(m_buffer.data(), fileSize);
+	}
 
-		while (!file.eof())
-		{
-			if (std::getline(file, fileLine))
-			{
-				if (fileLine.size() > 0)
-				{
-					std::string dataType = LineType(fileLine);
-					
-					// Skip all tests if dataType has a length of 0.
-					if (dataType.length() == 0)
-					{
-						continue;
-					}
+	file.close();
+	m_pData = m_buffer.data();
+	m_size = m_buffer.size();
+	return true;
+}
 
-					std::string data = LineData(fileLine);
+bool OBJModel::Load(const char* a_filename)
+{
+	// Copied first, the name may point at this model's file path, which is 
+	// replaced below.
+	const std::string filename = a_filename;
+	std::string filePath = filename;
+	size_t pathEnd = filePath.find_last_of("/\\");
 
-					if (dataType == "#")
-					{
-						std::cout << data << std::endl;
-						continue;
-					}
+	if (pathEnd != std::string::npos)
+	{
+		filePath = filePath.substr(0, pathEnd + 1);
+	}
+	else
+	{
+		filePath = "";
+	}
 
-					if (dataType == "newmtl")
-					{
-						std::cout << "New material found: " << data << std::endl;
+	m_filePath = filePath;
+	m_sourceFiles.clear();
+	m_sourceFiles.push_back(std::string(filename.c_str() + filePath.size()));
+	std::string cacheFilename = GetCacheFileName(filename.c_str());
+	m_parseStatistics = ParseStatistics();
+	auto cacheStart = std::chrono::high_resolution_clock::now();
 
-						if (m_pCurrentMaterial)
-						{
-							m_materials.push_back(m_pCurrentMaterial);
-						}
+	if (m_bUseCache && LoadCache(cacheFilename.c_str()))
+	{
+		std::chrono::duration<double> cacheTime = std::chrono::high_resolution_clock::now() - cacheStart;
+		std::cout << "Loaded " << filename << " from cache in " <<
+			cacheTime.count() * 1000.0 << " ms" << std::endl;
+		CalculateMeshBounds();
+		PackMeshes();
+		return true;
+	}
 
-						m_pCurrentMaterial = new OBJMaterial();
-						m_pCurrentMaterial->SetName(data);
-						continue;
-					}
+	std::cout << "Attempting to open file: " << filename << std::endl;
+	OBJMappedFile file;
 
-					if (dataType == "Ns")
-					{
-						if (m_pCurrentMaterial)
-						{
-							// Ns is guaranteed to be a single float value.
-							m_pCurrentMaterial->GetKS()->a = std::stof(data);
-						}
+	// Test to see if the file has opened correctly.
+	if (!file.Open(filename.c_str()))
+	{
+		return false;
+	}
 
-						continue;
-					}
+	std::cout << "Successfully Opened." << std::endl;
+	size_t fileSize = file.GetSize();
 
-					if (dataType == "Ka")
-					{
-						if (m_pCurrentMaterial)
-						{
-							// Process kA as vector string.
-							// Store alpha channel as it may contain refractive index.
-							float kAD = m_pCurrentMaterial->GetKA()->a;
-							m_pCurrentMaterial->SetKA(ProcessVectorString(data));
-							m_pCurrentMaterial->GetKA()->a = kAD;
-						}
+	if (fileSize == 0)
+	{
+		std::cout << "File contains no data, closing file." << std::endl;
+		return false;
+	}
 
-						continue;
+	const unsigned int kilobyte = 1024;
+	std::cout << "File size: " << fileSize / kilobyte << " KB" <<
+		(file.IsMapped() ? " (mapped)" : "") << std::endl;
+
+	auto parseStart = std::chrono::high_resolution_clock::now();
+	unsigned int threadCount = m_uiParseThreadCount;
+
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Small files aren't worth the cost of starting threads.
+	const size_t minimumChunkSize = 256 * kilobyte;
+	threadCount = (unsigned int)std::min<size_t>(threadCount,
+		std::max<size_t>(1, fileSize / minimumChunkSize));
+	// Split the file into chunks that start and end on line boundaries.
+	std::vector<OBJParseChunk> chunks(threadCount);
+	const char* pFileBegin = file.GetData();
+	const char* pFileEnd = pFileBegin + fileSize;
+	const char* pChunkBegin = pFileBegin;
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		const char* pChunkEnd = pFileEnd;
+
+		if (i + 1 < threadCount)
+		{
+			pChunkEnd = std::max(pChunkBegin, pFileBegin + fileSize / threadCount * (i + 1));
+			pChunkEnd = (const char*)memchr(pChunkEnd, '\n', pFileEnd - pChunkEnd);
+			pChunkEnd = pChunkEnd ? pChunkEnd + 1 : pFileEnd;
+		}
+
+		chunks[i].pBegin = pChunkBegin;
+		chunks[i].pEnd = pChunkEnd;
+		pChunkBegin = pChunkEnd;
+	}
+
+	// This thread parses the first chunk while workers parse the rest.
+	std::vector<std::thread> workers;
+
+	for (unsigned int i = 1; i < threadCount; ++i)
+	{
+		workers.push_back(std::thread(&OBJModel::ParseChunk, this, std::ref(chunks[i])));
+	}
+
+	ParseChunk(chunks[0]);
+
+	for (auto iterator = workers.begin(); iterator != workers.end(); ++iterator)
+	{
+		iterator->join();
+	}
+
+	BuildMeshes(chunks);
+	std::chrono::duration<double> parseTime = std::chrono::high_resolution_clock::now() - parseStart;
+	m_parseStatistics.threadCount = threadCount;
+	m_parseStatistics.parseTime = parseTime.count();
+	const double megabyte = 1024.0 * 1024.0;
+	std::cout << "Parsed in " << parseTime.count() * 1000.0 << " ms on " <<
+		threadCount << " thread(s) (" <<
+		(fileSize / megabyte) / parseTime.count() << " MB/s)" << std::endl;
+
+	// Caches for models on read only storage are baked ahead of time 
+	// instead.
+	if (m_bUseCache &&
+		!OBJMappedFile::IsReadOnlyPath(cacheFilename.c_str()) &&
+		!SaveCache(cacheFilename.c_str()))
+	{
+		std::cout << "Warning: Could not write model cache: " << cacheFilename << std::endl;
+	}
+
+	CalculateMeshBounds();
+	PackMeshes();
+	return true;
+}
+
+void OBJModel::SetParseThreadCount(unsigned int a_threadCount)
+{
+	m_uiParseThreadCount = a_threadCount;
+}
+
+const OBJModel::ParseStatistics& OBJModel::GetParseStatistics() const
+{
+	return m_parseStatistics;
+}
+
+void OBJModel::SetUseCache(bool a_useCache)
+{
+	m_bUseCache = a_useCache;
+}
+
+// Binary cache layout. The sections follow the header in the order they're 
+// declared, then each mesh's vertices and indices. Bump the version whenever 
+// the layout or OBJVertex changes.
+static const char sc_cacheMagic[4] = { 'O', 'B', 'J', 'C' };
+static const unsigned int sc_cacheVersion = 1;
+// Vertex and index data is aligned so it can be read in place.
+static const size_t sc_cacheAlignment = 16;
+
+typedef struct OBJCacheHeader
+{
+	char magic[4];
+	unsigned int version;
+	// Vertex positions are stored already scaled.
+	float modelScale;
+	unsigned int vertexSize;
+	unsigned int dependencyCount;
+	unsigned int materialCount;
+	unsigned int meshCount;
+	unsigned int stringTableSize;
+	// Total size of the cache, a mismatch means it was only partly written.
+	unsigned long long fileSize;
+} OBJCacheHeader;
+
+// A range of the string table.
+typedef struct OBJCacheString
+{
+	unsigned int offset;
+	unsigned int length;
+} OBJCacheString;
+
+// A source file the cache was built from, relative to the model's folder.
+typedef struct OBJCacheDependency
+{
+	unsigned long long size;
+	long long modifiedTime;
+	unsigned long long hash;
+	OBJCacheString fileName;
+} OBJCacheDependency;
+
+typedef struct OBJCacheMaterial
+{
+	OBJCacheString name;
+	// Relative to the model's folder.
+	OBJCacheString textureFileNames[OBJMaterial::TEXTURE_TYPES_COUNT];
+	glm::vec4 kA;
+	glm::vec4 kD;
+	glm::vec4 kS;
+} OBJCacheMaterial;
+
+typedef struct OBJCacheMesh
+{
+	OBJCacheString name;
+	// -1 if the mesh has no material.
+	int materialIndex;
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	unsigned int padding;
+	// Offsets from the start of the cache.
+	unsigned long long vertexOffset;
+	unsigned long long indexOffset;
+} OBJCacheMesh;
+
+bool OBJModel::LoadCache(const char* a_cacheFilename)
+{
+	OBJMappedFile file;
+
+	if (!file.Open(a_cacheFilename) || file.GetSize() < sizeof(OBJCacheHeader))
+	{
+		return false;
+	}
+
+	const char* pData = file.GetData();
+	const size_t fileSize = file.GetSize();
+	OBJCacheHeader header;
+	memcpy(&header, pData, sizeof(header));
+
+	if (memcmp(header.magic, sc_cacheMagic, sizeof(sc_cacheMagic)) != 0 ||
+		header.version != sc_cacheVersion ||
+		header.vertexSize != sizeof(OBJVertex) ||
+		header.modelScale != m_fModelScale ||
+		header.fileSize != fileSize)
+	{
+		std::cout << "Model cache is out of date: " << a_cacheFilename << std::endl;
+		return false;
+	}
+
+	unsigned long long tablesSize = sizeof(OBJCacheHeader) +
+		(unsigned long long)header.dependencyCount * sizeof(OBJCacheDependency) +
+		(unsigned long long)header.materialCount * sizeof(OBJCacheMaterial) +
+		(unsigned long long)header.meshCount * sizeof(OBJCacheMesh) +
+		header.stringTableSize;
+
+	if (tablesSize > fileSize)
+	{
+		return false;
+	}
+
+	const OBJCacheDependency* pDependencies = (const OBJCacheDependency*)(pData + sizeof(OBJCacheHeader));
+	const OBJCacheMaterial* pMaterials = (const OBJCacheMaterial*)(pDependencies + header.dependencyCount);
+	const OBJCacheMesh* pMeshes = (const OBJCacheMesh*)(pMaterials + header.materialCount);
+	const char* pStrings = (const char*)(pMeshes + header.meshCount);
+	bool stringsValid = true;
+
+	auto getString = [&](const OBJCacheString& a_string)
+	{
+		if ((unsigned long long)a_string.offset + a_string.length > header.stringTableSize)
+		{
+			stringsValid = false;
+			return std::string();
+		}
+
+		return std::string(pStrings + a_string.offset, a_string.length);
+	};
+
+	// Make sure no source file has changed since the cache was written.
+	std::vector<std::string> sourceFiles;
+
+	for (unsigned int i = 0; i < header.dependencyCount; ++i)
+	{
+		const OBJCacheDependency& dependency = pDependencies[i];
+		sourceFiles.push_back(getString(dependency.fileName));
+		std::string sourceFile = m_filePath + sourceFiles.back();
+		unsigned long long size = 0;
+		long long modifiedTime = 0;
+
+		if (!stringsValid ||
+			!OBJMappedFile::GetFileStamp(sourceFile.c_str(), size, modifiedTime) ||
+			size != dependency.size)
+		{
+			std::cout << "Model cache is out of date: " << a_cacheFilename << std::endl;
+			return false;
+		}
+
+		// A new timestamp alone doesn't mean the contents changed. A 
+		// missing one means the platform couldn't tell.
+		if (modifiedTime == 0 || modifiedTime != dependency.modifiedTime)
+		{
+			OBJMappedFile sourceData;
+
+			if (!sourceData.Open(sourceFile.c_str()) ||
+				sourceData.GetHash() != dependency.hash)
+			{
+				std::cout << "Model cache is out of date: " << a_cacheFilename << std::endl;
+				return false;
+			}
+		}
+	}
+
+	// Check every mesh fits inside the cache before creating anything.
+	for (unsigned int i = 0; i < header.meshCount; ++i)
+	{
+		const OBJCacheMesh& mesh = pMeshes[i];
+
+		if (mesh.vertexOffset > fileSize ||
+			mesh.indexOffset > fileSize ||
+			(fileSize - mesh.vertexOffset) / sizeof(OBJVertex) < mesh.vertexCount ||
+			(fileSize - mesh.indexOffset) / sizeof(unsigned int) < mesh.indexCount ||
+			mesh.materialIndex >= (int)header.materialCount)
+		{
+			return false;
+		}
+	}
+
+	std::vector<OBJMaterial*> materials;
+
+	for (unsigned int i = 0; i < header.materialCount; ++i)
+	{
+		const OBJCacheMaterial& cachedMaterial = pMaterials[i];
+		OBJMaterial* pMaterial = new OBJMaterial();
+		pMaterial->SetName(getString(cachedMaterial.name));
+
+		for (unsigned int j = 0; j < OBJMaterial::TEXTURE_TYPES_COUNT; ++j)
+		{
+			if (cachedMaterial.textureFileNames[j].length > 0)
+			{
+				pMaterial->SetTextureFileName((OBJMaterial::TEXTURE_TYPES)j,
+					m_filePath + getString(cachedMaterial.textureFileNames[j]));
+			}
+		}
+
+		pMaterial->SetKA(cachedMaterial.kA);
+		pMaterial->SetKD(cachedMaterial.kD);
+		pMaterial->SetKS(cachedMaterial.kS);
+		materials.push_back(pMaterial);
+	}
+
+	std::vector<OBJMesh*> meshes;
+
+	for (unsigned int i = 0; i < header.meshCount; ++i)
+	{
+		const OBJCacheMesh& cachedMesh = pMeshes[i];
+		const OBJVertex* pVertices = (const OBJVertex*)(pData + cachedMesh.vertexOffset);
+		const unsigned int* pIndices = (const unsigned int*)(pData + cachedMesh.indexOffset);
+		OBJMesh* pMesh = new OBJMesh();
+		pMesh->SetName(getString(cachedMesh.name));
+		pMesh->GetVertices()->assign(pVertices, pVertices + cachedMesh.vertexCount);
+		pMesh->GetIndices()->assign(pIndices, pIndices + cachedMesh.indexCount);
+
+		if (cachedMesh.materialIndex >= 0)
+		{
+			pMesh->SetMaterial(materials[cachedMesh.materialIndex]);
+		}
+
+		meshes.push_back(pMesh);
+	}
+
+	if (!stringsValid)
+	{
+		for (auto iterator = meshes.begin(); iterator != meshes.end(); ++iterator)
+		{
+			delete *iterator;
+		}
+
+		for (auto iterator = materials.begin(); iterator != materials.end(); ++iterator)
+		{
+			delete *iterator;
+		}
+
+		return false;
+	}
+
+	m_meshes.insert(m_meshes.end(), meshes.begin(), meshes.end());
+	m_materials.insert(m_materials.end(), materials.begin(), materials.end());
+	m_sourceFiles = sourceFiles;
+	return true;
+}
+
+bool OBJModel::SaveCache(const char* a_cacheFilename) const
+{
+	// The cache stores full precision vertices, which packing discards.
+	for (auto iterator = m_meshes.begin(); iterator != m_meshes.end(); ++iterator)
+	{
+		if ((*iterator)->IsPacked())
+		{
+			return false;
+		}
+	}
+
+	std::string strings;
+
+	auto addString = [&strings](const std::string& a_string)
+	{
+		OBJCacheString cacheString = { (unsigned int)strings.size(), (unsigned int)a_string.size() };
+		strings += a_string;
+		return cacheString;
+	};
+
+	// Paths are stored relative to the model's folder.
+	auto relativePath = [this](std::string a_path)
+	{
+		if (a_path.compare(0, m_filePath.size(), m_filePath) == 0)
+		{
+			a_path.erase(0, m_filePath.size());
+		}
+
+		return a_path;
+	};
+
+	std::vector<OBJCacheDependency> dependencies;
+
+	for (auto iterator = m_sourceFiles.begin(); iterator != m_sourceFiles.end(); ++iterator)
+	{
+		std::string sourceFile = m_filePath + *iterator;
+		OBJCacheDependency dependency;
+		OBJMappedFile sourceData;
+
+		if (!OBJMappedFile::GetFileStamp(sourceFile.c_str(), dependency.size, dependency.modifiedTime) ||
+			!sourceData.Open(sourceFile.c_str()))
+		{
+			return false;
+		}
+
+		dependency.hash = sourceData.GetHash();
+		dependency.fileName = addString(*iterator);
+		dependencies.push_back(dependency);
+	}
+
+	std::vector<OBJCacheMaterial> materials;
+
+	for (auto iterator = m_materials.begin(); iterator != m_materials.end(); ++iterator)
+	{
+		OBJMaterial* pMaterial = *iterator;
+		OBJCacheMaterial material;
+		material.name = addString(pMaterial->GetName());
+
+		for (unsigned int i = 0; i < OBJMaterial::TEXTURE_TYPES_COUNT; ++i)
+		{
+			material.textureFileNames[i] = addString(relativePath(pMaterial->GetTextureFileName(i)));
+		}
+
+		material.kA = *pMaterial->GetKA();
+		material.kD = *pMaterial->GetKD();
+		material.kS = *pMaterial->GetKS();
+		materials.push_back(material);
+	}
+
+	auto align = [](unsigned long long a_offset)
+	{
+		return (a_offset + sc_cacheAlignment - 1) & ~(unsigned long long)(sc_cacheAlignment - 1);
+	};
+
+	std::vector<OBJCacheMesh> meshes;
+
+	for (auto iterator = m_meshes.begin(); iterator != m_meshes.end(); ++iterator)
+	{
+		OBJMesh* pMesh = *iterator;
+		OBJCacheMesh mesh;
+		mesh.name = addString(pMesh->GetName());
+		auto material = std::find(m_materials.begin(), m_materials.end(), pMesh->GetMaterial());
+		mesh.materialIndex = material != m_materials.end() ?
+			(int)(material - m_materials.begin()) : -1;
+		mesh.vertexCount = (unsigned int)pMesh->GetVertices()->size();
+		mesh.indexCount = (unsigned int)pMesh->GetIndices()->size();
+		mesh.padding = 0;
+		meshes.push_back(mesh);
+	}
+
+	// Lay out the vertex and index data after the tables.
+	unsigned long long offset = sizeof(OBJCacheHeader) +
+		dependencies.size() * sizeof(OBJCacheDependency) +
+		materials.size() * sizeof(OBJCacheMaterial) +
+		meshes.size() * sizeof(OBJCacheMesh) +
+		strings.size();
+
+	for (auto iterator = meshes.begin(); iterator != meshes.end(); ++iterator)
+	{
+		iterator->vertexOffset = offset = align(offset);
+		offset += iterator->vertexCount * sizeof(OBJVertex);
+		iterator->indexOffset = offset = align(offset);
+		offset += iterator->indexCount * sizeof(unsigned int);
+	}
+
+	OBJCacheHeader header;
+	memcpy(header.magic, sc_cacheMagic, sizeof(sc_cacheMagic));
+	header.version = sc_cacheVersion;
+	header.modelScale = m_fModelScale;
+	header.vertexSize = sizeof(OBJVertex);
+	header.dependencyCount = (unsigned int)dependencies.size();
+	header.materialCount = (unsigned int)materials.size();
+	header.meshCount = (unsigned int)meshes.size();
+	header.stringTableSize = (unsigned int)strings.size();
+	header.fileSize = offset;
+	std::fstream file;
+	file.open(a_cacheFilename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)dependencies.data(), dependencies.size() * sizeof(OBJCacheDependency));
+	file.write((const char*)materials.data(), materials.size() * sizeof(OBJCacheMaterial));
+	file.write((const char*)meshes.data(), meshes.size() * sizeof(OBJCacheMesh));
+	file.write(strings.data(), strings.size());
+	const char padding[sc_cacheAlignment] = {};
+
+	for (unsigned int i = 0; i < meshes.size(); ++i)
+	{
+		std::vector<OBJVertex>* pVertices = m_meshes[i]->GetVertices();
+		std::vector<unsigned int>* pIndices = m_meshes[i]->GetIndices();
+		file.write(padding, meshes[i].vertexOffset - (unsigned long long)file.tellp());
+		file.write((const char*)pVertices->data(), pVertices->size() * sizeof(OBJVertex));
+		file.write(padding, meshes[i].indexOffset - (unsigned long long)file.tellp());
+		file.write((const char*)pIndices->data(), pIndices->size() * sizeof(unsigned int));
+	}
+
+	bool success = file.good();
+	file.close();
+
+	if (!success)
+	{
+		remove(a_cacheFilename);
+	}
+
+	return success;
+}
+
+void OBJModel::SetVertexFormat(VERTEX_FORMATS a_vertexFormat)
+{
+	m_vertexFormat = a_vertexFormat;
+}
+
+OBJModel::VERTEX_FORMATS OBJModel::GetVertexFormat() const
+{
+	return m_vertexFormat;
+}
+
+std::string OBJModel::GetCacheFileName(const char* a_filename)
+{
+	return std::string(a_filename) + ".cache";
+}
+
+void OBJModel::ParseChunk(OBJParseChunk& a_chunk) const
+{
+	const char* pCursor = a_chunk.pBegin;
+	const char* pChunkEnd = a_chunk.pEnd;
+
+	while (pCursor < pChunkEnd)
+	{
+		const char* pLineEnd = (const char*)memchr(pCursor, '\n', pChunkEnd - pCursor);
+
+		if (!pLineEnd)
+		{
+			pLineEnd = pChunkEnd;
+		}
+
+		const char* pToken = SkipWhitespace(pCursor, pLineEnd);
+		const char* pTokenEnd = SkipToken(pToken, pLineEnd);
+		size_t tokenLength = pTokenEnd - pToken;
+		const char* pData = SkipWhitespace(pTokenEnd, pLineEnd);
+		// Move on to the next line before processing so each branch below 
+		// can simply continue.
+		pCursor = pLineEnd + 1;
+
+		// If the line has no token then skip all tests and continue to the 
+		// next line.
+		if (tokenLength == 0)
+		{
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "v")) // Data is a vector.
+		{
+			glm::vec4 vertex = ProcessVector(pData, pLineEnd);
+			// Multiply by passed in vector to allow scaling of the model.
+			vertex *= m_fModelScale;
+			// As this is positional data ensure the w component is set to 
+			// 1.0f;
+			vertex.w = 1.f;
+			a_chunk.vertexData.push_back(vertex);
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "vt")) // Data is a UV coordinate.
+		{
+			glm::vec4 uvCoordinateV4 = ProcessVector(pData, pLineEnd);
+			a_chunk.uvData.push_back(glm::vec2(uvCoordinateV4.x, uvCoordinateV4.y));
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "vn")) // Data is a normal.
+		{
+			glm::vec4 normal = ProcessVector(pData, pLineEnd);
+			normal.w = 0.f;
+			a_chunk.normalData.push_back(normal);
+			continue;
+		}
+
+		OBJRecord record;
+		record.vertexCount = (unsigned int)a_chunk.vertexData.size();
+		record.uvCount = (unsigned int)a_chunk.uvData.size();
+		record.normalCount = (unsigned int)a_chunk.normalData.size();
+
+		if (TokenEquals(pToken, tokenLength, "f")) // Data is a face.
+		{
+			record.type = RECORD_TYPES_FACE;
+			record.start = (unsigned int)a_chunk.corners.size();
+			// Face consists of 3 -> more triplets separated by whitespace.
+			const char* pTriplet = pData;
+
+			while (pTriplet < pLineEnd)
+			{
+				OBJFaceTriplet triplet;
+				const char* pTripletEnd = ProcessTriplet(pTriplet, pLineEnd, triplet);
+
+				if (pTripletEnd == pTriplet)
+				{
+					break;
+				}
+
+				a_chunk.corners.push_back(triplet);
+				pTriplet = SkipWhitespace(pTripletEnd, pLineEnd);
+			}
+
+			record.count = (unsigned int)a_chunk.corners.size() - record.start;
+			a_chunk.records.push_back(record);
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "#"))
+		{
+			record.type = RECORD_TYPES_COMMENT;
+		}
+		else if (TokenEquals(pToken, tokenLength, "mtllib"))
+		{
+			record.type = RECORD_TYPES_MATERIAL_LIBRARY;
+		}
+		else if (TokenEquals(pToken, tokenLength, "g") ||
+			TokenEquals(pToken, tokenLength, "o"))
+		{
+			record.type = RECORD_TYPES_GROUP;
+		}
+		else if (TokenEquals(pToken, tokenLength, "usemtl"))
+		{
+			record.type = RECORD_TYPES_USE_MATERIAL;
+		}
+		else
+		{
+			continue;
+		}
+
+		record.start = (unsigned int)(pData - a_chunk.pBegin);
+		record.count = (unsigned int)(TrimLineEnd(pData, pLineEnd) - pData);
+		a_chunk.records.push_back(record);
+	}
+}
+
+void OBJModel::BuildMeshes(std::vector<OBJParseChunk>& a_chunks)
+{
+	// Join each chunk's vertex data so face indices can address it directly.
+	std::vector<glm::vec4> vertexData;
+	std::vector<glm::vec4> normalData;
+	std::vector<glm::vec2> uvData;
+
+	for (auto iterator = a_chunks.begin(); iterator != a_chunks.end(); ++iterator)
+	{
+		vertexData.insert(vertexData.end(), iterator->vertexData.begin(), iterator->vertexData.end());
+		normalData.insert(normalData.end(), iterator->normalData.begin(), iterator->normalData.end());
+		uvData.insert(uvData.end(), iterator->uvData.begin(), iterator->uvData.end());
+	}
+
+	OBJMesh* pCurrentMesh = nullptr;
+	// Store out material is a string as face data is not generated prior 
+	// to material assignment and may not have a mesh.
+	OBJMaterial* pCurrentMtl = nullptr;
+	// Attribute counts read by the chunks before the current one.
+	unsigned int vertexBase = 0;
+	unsigned int uvBase = 0;
+	unsigned int normalBase = 0;
+	// Vertex each unique face triplet was given in the current mesh.
+	std::unordered_map<OBJFaceTriplet, unsigned int, OBJFaceTripletHash> meshVertices;
+	// The current face's vertex indices, reused between faces.
+	std::vector<unsigned int> faceIndices;
+	size_t cornerCount = 0;
+	size_t skippedFaces = 0;
+
+	for (auto chunk = a_chunks.begin(); chunk != a_chunks.end(); ++chunk)
+	{
+		for (auto record = chunk->records.begin(); record != chunk->records.end(); ++record)
+		{
+			if (record->type == RECORD_TYPES_FACE)
+			{
+				// Only data read before the face may be referenced by it.
+				unsigned int vertexCount = vertexBase + record->vertexCount;
+				unsigned int uvCount = uvBase + record->uvCount;
+				unsigned int normalCount = normalBase + record->normalCount;
+				bool validFace = true;
+
+				// Faces are checked whole before any vertex is made, so a 
+				// bad corner can't leave a smaller face or stray vertices.
+				for (unsigned int i = 0; i < record->count && validFace; ++i)
+				{
+					const OBJFaceTriplet& triplet = chunk->corners[record->start + i];
+					validFace = triplet.vertex != 0 &&
+						triplet.vertex <= vertexCount &&
+						triplet.uvCoordinate <= uvCount &&
+						triplet.normalVertex <= normalCount;
+				}
+
+				// Skip faces that reference data we haven't read.
+				if (!validFace)
+				{
+					++skippedFaces;
+					continue;
+				}
+
+				// We have entered processing faces without having hit a 'o' 
+				// or 'g' tag.
+				if (!pCurrentMesh)
+				{
+					pCurrentMesh = new OBJMesh();
+					meshVertices.clear();
+
+					if (pCurrentMtl)
+					{
+						pCurrentMesh->SetMaterial(pCurrentMtl);
+						pCurrentMtl = nullptr;
+					}
+				}
+
+				std::vector<OBJVertex>& vertices = *pCurrentMesh->GetVertices();
+				std::vector<unsigned int>& indices = *pCurrentMesh->GetIndices();
+				// Test to see if the OBJ file contains normal data, if no 
+				// normals have been read then there are no normals.
+				bool calculateNormals = normalCount == 0;
+				faceIndices.clear();
+
+				for (unsigned int i = 0; i < record->count; ++i)
+				{
+					const OBJFaceTriplet& triplet = chunk->corners[record->start + i];
+					++cornerCount;
+
+					// Corners with the same indices share a vertex, unless 
+					// the vertex is about to be given this face's normal.
+					if (!calculateNormals)
+					{
+						auto sharedVertex = meshVertices.find(triplet);
+
+						if (sharedVertex != meshVertices.end())
+						{
+							faceIndices.push_back(sharedVertex->second);
+							continue;
+						}
+
+						meshVertices[triplet] = (unsigned int)vertices.size();
+					}
+
+					// Triplet processed new set vertex data from 
+					// position/normal/texture data.
+					OBJVertex currentVertex;
+					currentVertex.SetPosition(vertexData[triplet.vertex - 1]);
+
+					if (triplet.normalVertex != 0)
+					{
+						currentVertex.SetNormal(normalData[triplet.normalVertex - 1]);
+					}
+
+					if (triplet.uvCoordinate != 0)
+					{
+						currentVertex.SetUVCoordinate(uvData[triplet.uvCoordinate - 1]);
+					}
+
+					faceIndices.push_back((unsigned int)vertices.size());
+					vertices.push_back(currentVertex);
+				}
+
+				// All face information for the tri/quad/fan have been 
+				// collected. Time to index these into the current mesh.
+				for (unsigned int offset = 1; offset + 1 < faceIndices.size(); ++offset)
+				{
+					indices.push_back(faceIndices[0]);
+					indices.push_back(faceIndices[offset]);
+					indices.push_back(faceIndices[offset + 1]);
+
+					if (calculateNormals)
+					{
+						glm::vec4 normal = pCurrentMesh->CalculateFaceNormal(faceIndices[0],
+							faceIndices[offset],
+							faceIndices[offset + 1]);
+						vertices[faceIndices[0]].SetNormal(normal);
+						vertices[faceIndices[offset]].SetNormal(normal);
+						vertices[faceIndices[offset + 1]].SetNormal(normal);
 					}
+				}
+
+				continue;
+			}
+
+			std::string data(chunk->pBegin + record->start, record->count);
+
+			if (record->type == RECORD_TYPES_COMMENT)
+			{
+				// This is a comment line.
+				std::cout << data << std::endl;
+				continue;
+			}
+
+			if (record->type == RECORD_TYPES_MATERIAL_LIBRARY)
+			{
+				std::cout << "Material File: " << data << std::endl;
+				// Load in material fle so that materials can be used as 
+				// required.
+				auto materialStart = std::chrono::high_resolution_clock::now();
+				LoadMaterialLibrary(data);
+				std::chrono::duration<double> materialTime = std::chrono::high_resolution_clock::now() - materialStart;
+				m_parseStatistics.materialLibraryTime += materialTime.count();
+				continue;
+			}
+
+			if (record->type == RECORD_TYPES_GROUP)
+			{
+				std::cout << "OBJ Group Found: " << data << std::endl;
+
+				// We can use group tags to split our model into smaller mesh 
+				// components.
+				if (pCurrentMesh != nullptr)
+				{
+					m_meshes.push_back(pCurrentMesh);
+				}
+
+				pCurrentMesh = new OBJMesh();
+				pCurrentMesh->SetName(data);
+				meshVertices.clear();
+
+				// If we have a material name.
+				if (pCurrentMtl)
+				{
+					pCurrentMesh->SetMaterial(pCurrentMtl);
+					pCurrentMtl = nullptr;
+				}
+
+				continue;
+			}
+
+			if (record->type == RECORD_TYPES_USE_MATERIAL)
+			{
+				// We have a material to use on the current mesh.
+				OBJMaterial* pMtl = GetMaterialByName(data.c_str());
+
+				if (pMtl)
+				{
+					pCurrentMtl = pMtl;
+
+					if (pCurrentMesh)
+					{
+						pCurrentMesh->SetMaterial(pCurrentMtl);
+					}
+				}
+
+				continue;
+			}
+		}
+
+		vertexBase += (unsigned int)chunk->vertexData.size();
+		uvBase += (unsigned int)chunk->uvData.size();
+		normalBase += (unsigned int)chunk->normalData.size();
+	}
+
+	if (pCurrentMesh)
+	{
+		m_meshes.push_back(pCurrentMesh);
+	}
+
+	size_t vertexTotal = 0;
+
+	for (auto iterator = m_meshes.begin(); iterator != m_meshes.end(); ++iterator)
+	{
+		vertexTotal += (*iterator)->GetVertices()->size();
+	}
+
+	if (skippedFaces > 0)
+	{
+		std::cout << "Warning: Skipped " << skippedFaces << " face(s) referencing missing vertex data." << std::endl;
+	}
+
+	const unsigned int kilobyte = 1024;
+	std::cout << "Vertices: " << vertexTotal << " shared by " << cornerCount <<
+		" face corners (" << (cornerCount - vertexTotal) * sizeof(OBJVertex) / kilobyte <<
+		" KB less vertex data)" << std::endl;
+}
+
+// Fits bounding volumes around every mesh.
+void OBJModel::CalculateMeshBounds()
+{
+	for (auto iterator = m_meshes.begin(); iterator != m_meshes.end(); ++iterator)
+	{
+		(*iterator)->CalculateBounds();
+	}
+}
+
+// Converts every mesh to the packed vertex format if it was requested.
+void OBJModel::PackMeshes()
+{
+	if (m_vertexFormat != VERTEX_FORMATS_PACKED)
+	{
+		return;
+	}
+
+	size_t vertexCount = 0;
+	float maxNormalError = 0.f;
+	float maxUVError = 0.f;
+
+	for (auto iterator = m_meshes.begin(); iterator != m_meshes.end(); ++iterator)
+	{
+		float normalError = 0.f;
+		float uvError = 0.f;
+		vertexCount += (*iterator)->GetVertices()->size();
+		(*iterator)->PackVertices(normalError, uvError);
+		maxNormalError = std::max(maxNormalError, normalError);
+		maxUVError = std::max(maxUVError, uvError);
+	}
 
-					if (dataType == "Kd")
-					{
-						if (m_pCurrentMaterial)
-						{
-							// Process kD as vector string.
-							// Store alpha as it may contain dissolve value.
-							float kDA = m_pCurrentMaterial->GetKD()->a;
-							m_pCurrentMaterial->SetKD(ProcessVectorString(data));
-							m_pCurrentMaterial->GetKD()->a = kDA;
-						}
+	const unsigned int kilobyte = 1024;
+	std::cout << "Packed " << vertexCount << " vertices: " <<
+		vertexCount * sizeof(OBJVertex) / kilobyte << " KB -> " <<
+		vertexCount * sizeof(OBJPackedVertex) / kilobyte << " KB (max normal error " <<
+		maxNormalError << " degrees, max UV error " << maxUVError << ")" << std::endl;
+}
 
-						continue;
-					}
+// Unloads and frees memory.
+void OBJModel::Unload()
+{
+	m_meshes.clear();
+}
 
-					if (dataType == "Ks")
-					{
-						if (m_pCurrentMaterial)
-						{
-							// Process Ks as vector string.
-							// Store alpha as it may contain specular component.
-							float kSA = m_pCurrentMaterial->GetKS()->a;
-							m_pCurrentMaterial->SetKS(ProcessVectorString(data));
-							m_pCurrentMaterial->GetKS()->a = kSA;
-						}
+const char* OBJModel::GetFilePath() const
+{
+	return m_filePath.c_str();
+}
 
-						continue;
-					}
+const unsigned int OBJModel::GetMeshCount() const
+{
+	return (unsigned int)m_meshes.size();
+}
 
-					if (dataType == "Ke")
-					{
-						// Ke is for emissive properties.
-						// Don't need to support this for our purposes.
-						continue;
-					}
+const unsigned int OBJModel::GetMaterialCount() const
+{
+	return (unsigned int)m_materials.size();
+}
 
-					if (dataType == "Ni")
-					{
-						if (m_pCurrentMaterial)
-						{
-							// This is the refractive index of the mesh (how 
-							// light bends as it passes through the material).
-							// We'll store this in the alpha component of the 
-							// ambient light values (Ka).
-							m_pCurrentMaterial->GetKA()->a = std::stof(data);
-						}
+OBJMesh* OBJModel::GetMeshByIndex(unsigned int a_index)
+{
+	unsigned int meshCount = (unsigned int)m_meshes.size();
 
-						continue;
-					}
+	if (meshCount > 0 && a_index < meshCount)
+	{
+		return m_meshes[a_index];
+	}
 
-					if (dataType == "d" || dataType == "Tr")
-					{
-						if (m_pCurrentMaterial)
-						{
-							// This is the dissolve or alpha value of the 
-							// material. We'll store this in the Kd alpha 
-							// channel.
-							m_pCurrentMaterial->GetKD()->a = std::stof(data);
-
-							if (dataType == "Tr")
-							{
-								m_pCurrentMaterial->GetKD()->a = 1.f - m_pCurrentMaterial->GetKD()->a;
-							}
-						}
+	return nullptr;
+}
 
-						continue;
-					}
+OBJMaterial* OBJModel::GetMaterialByName(const char* a_name)
+{
+	for (auto iterator = m_materials.begin();
+		iterator != m_materials.end();
+		++iterator)
+	{
+		OBJMaterial* pMaterial = (*iterator);
+		
+		if (pMaterial->GetName() == a_name)
+		{
+			return pMaterial;
+		}
+	}
 
-					if (dataType == "illum")
-					{
-						// Illum describes the illumintation model used to 
-						// light the model. Ignoe this as we'll light the 
-						// scene our own way.
-						continue;
-					}
+	return nullptr;
+}
 
-					// Diffuse texture.
-					if (dataType == "map_Kd")
-					{
-						std::vector<std::string> mapData = SplitStringAtCharacter(data, ' ');
-						m_pCurrentMaterial->SetTextureFileName(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_DIFFUSE,
-							m_filePath + mapData[mapData.size() - 1]);
-						continue;
-					}
+OBJMaterial* OBJModel::GetMaterialByIndex(unsigned int a_index)
+{
+	unsigned int materialCount = (unsigned int)m_materials.size();
+	
+	if (materialCount > 0 && a_index < materialCount)
+	{
+		return m_materials[a_index];
+	}
 
-					// Specular texture.
-					if (dataType == "map_Ks")
-					{
-						std::vector<std::string> mapData = SplitStringAtCharacter(data, ' ');
-						m_pCurrentMaterial->SetTextureFileName(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_SPECULAR,
-							m_filePath + mapData[mapData.size() - 1]);
-						continue;
-					}
+	return nullptr;
+}
 
-					// Normal map texture. Map_bump or bump for OBJ files.
-					if (dataType == "map_bump" || dataType == "bump")
-					{
-						std::vector<std::string> mapData = SplitStringAtCharacter(data, ' ');
-						m_pCurrentMaterial->SetTextureFileName(OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_NORMAL,
-							m_filePath + mapData[mapData.size() - 1]);
-						continue;
-					}
-				}
+void OBJModel::LoadMaterialLibrary(std::string a_mtllib)
+{
+	std::string materialFile = m_filePath + a_mtllib;
+	std::cout << "Attempting to load material file: " << materialFile << std::endl;
+	OBJMappedFile file;
+
+	// Test to see if the file has opened correctly.
+	if (!file.Open(materialFile.c_str()))
+	{
+		std::cout << "Error: Material Library Opening Unsuccessful.\n";
+		return;
+	}
+
+	std::cout << "Material Library Successfully Opened\n";
+	m_sourceFiles.push_back(a_mtllib);
+
+	// If our file has no data return early.
+	if (file.GetSize() == 0)
+	{
+		std::cout << "File contains no data, closing file.\n";
+		return;
+	}
+
+	const unsigned int kilobyte = 1024;
+	std::cout << "Material File Size: " << file.GetSize() / kilobyte << " KB" << std::endl;
+	const char* pCursor = file.GetData();
+	const char* pFileEnd = pCursor + file.GetSize();
+	m_pCurrentMaterial = nullptr;
+
+	while (pCursor < pFileEnd)
+	{
+		const char* pLineEnd = (const char*)memchr(pCursor, '\n', pFileEnd - pCursor);
+
+		if (!pLineEnd)
+		{
+			pLineEnd = pFileEnd;
+		}
+
+		const char* pToken = SkipWhitespace(pCursor, pLineEnd);
+		const char* pTokenEnd = SkipToken(pToken, pLineEnd);
+		size_t tokenLength = pTokenEnd - pToken;
+		const char* pData = SkipWhitespace(pTokenEnd, pLineEnd);
+		const char* pDataEnd = TrimLineEnd(pData, pLineEnd);
+		pCursor = pLineEnd + 1;
+
+		// Skip all tests if the line has no token.
+		if (tokenLength == 0)
+		{
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "#"))
+		{
+			std::cout.write(pData, pDataEnd - pData);
+			std::cout << std::endl;
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "newmtl"))
+		{
+			std::string name(pData, pDataEnd);
+			std::cout << "New material found: " << name << std::endl;
+
+			if (m_pCurrentMaterial)
+			{
+				m_materials.push_back(m_pCurrentMaterial);
+			}
+
+			m_pCurrentMaterial = new OBJMaterial();
+			m_pCurrentMaterial->SetName(name);
+			continue;
+		}
+
+		// Every remaining property belongs to a material.
+		if (!m_pCurrentMaterial)
+		{
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "Ns"))
+		{
+			// Ns is guaranteed to be a single float value.
+			ParseFloat(pData, pDataEnd, m_pCurrentMaterial->GetKS()->a);
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "Ka"))
+		{
+			// Process kA as vector string.
+			// Store alpha channel as it may contain refractive index.
+			float kAD = m_pCurrentMaterial->GetKA()->a;
+			m_pCurrentMaterial->SetKA(ProcessVector(pData, pDataEnd));
+			m_pCurrentMaterial->GetKA()->a = kAD;
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "Kd"))
+		{
+			// Process kD as vector string.
+			// Store alpha as it may contain dissolve value.
+			float kDA = m_pCurrentMaterial->GetKD()->a;
+			m_pCurrentMaterial->SetKD(ProcessVector(pData, pDataEnd));
+			m_pCurrentMaterial->GetKD()->a = kDA;
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "Ks"))
+		{
+			// Process Ks as vector string.
+			// Store alpha as it may contain specular component.
+			float kSA = m_pCurrentMaterial->GetKS()->a;
+			m_pCurrentMaterial->SetKS(ProcessVector(pData, pDataEnd));
+			m_pCurrentMaterial->GetKS()->a = kSA;
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "Ke"))
+		{
+			// Ke is for emissive properties.
+			// Don't need to support this for our purposes.
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "Ni"))
+		{
+			// This is the refractive index of the mesh (how light bends as it 
+			// passes through the material). We'll store this in the alpha 
+			// component of the ambient light values (Ka).
+			ParseFloat(pData, pDataEnd, m_pCurrentMaterial->GetKA()->a);
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "d") ||
+			TokenEquals(pToken, tokenLength, "Tr"))
+		{
+			// This is the dissolve or alpha value of the material. We'll store 
+			// this in the Kd alpha channel.
+			ParseFloat(pData, pDataEnd, m_pCurrentMaterial->GetKD()->a);
+
+			if (TokenEquals(pToken, tokenLength, "Tr"))
+			{
+				m_pCurrentMaterial->GetKD()->a = 1.f - m_pCurrentMaterial->GetKD()->a;
+			}
+
+			continue;
+		}
+
+		if (TokenEquals(pToken, tokenLength, "illum"))
+		{
+			// Illum describes the illumintation model used to light the model. 
+			// Ignoe this as we'll light the scene our own way.
+			continue;
+		}
+
+		// Texture maps may be preceded by options, the file name is always 
+		// the last space separated part of the line.
+		OBJMaterial::TEXTURE_TYPES textureType = OBJMaterial::TEXTURE_TYPES_COUNT;
+
+		// Diffuse texture.
+		if (TokenEquals(pToken, tokenLength, "map_Kd"))
+		{
+			textureType = OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_DIFFUSE;
+		}
+		// Specular texture.
+		else if (TokenEquals(pToken, tokenLength, "map_Ks"))
+		{
+			textureType = OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_SPECULAR;
+		}
+		// Normal map texture. Map_bump or bump for OBJ files.
+		else if (TokenEquals(pToken, tokenLength, "map_bump") ||
+			TokenEquals(pToken, tokenLength, "bump"))
+		{
+			textureType = OBJMaterial::TEXTURE_TYPES::TEXTURE_TYPES_NORMAL;
+		}
+
+		if (textureType != OBJMaterial::TEXTURE_TYPES_COUNT)
+		{
+			const char* pFileName = pDataEnd;
+
+			while (pFileName > pData && pFileName[-1] != ' ')
+			{
+				--pFileName;
+			}
+
+			m_pCurrentMaterial->SetTextureFileName(textureType,
+				m_filePath + std::string(pFileName, pDataEnd));
+			continue;
+		}
+	}
+
+	if (m_pCurrentMaterial)
+	{
+		m_materials.push_back(m_pCurrentMaterial);
+		m_pCurrentMaterial = nullptr;
+	}
+}
+
+const char* OBJModel::SkipWhitespace(const char* a_pCursor, const char* a_pEnd)
+{
+	while (a_pCursor < a_pEnd &&
+		(*a_pCursor == ' ' || *a_pCursor == '\t' || *a_pCursor == '\r'))
+	{
+		++a_pCursor;
+	}
+
+	return a_pCursor;
+}
+
+const char* OBJModel::SkipToken(const char* a_pCursor, const char* a_pEnd)
+{
+	while (a_pCursor < a_pEnd &&
+		*a_pCursor != ' ' && *a_pCursor != '\t' && *a_pCursor != '\r')
+	{
+		++a_pCursor;
+	}
+
+	return a_pCursor;
+}
+
+// Returns the end of the range with any trailing whitespace removed.
+const char* OBJModel::TrimLineEnd(const char* a_pBegin, const char* a_pEnd)
+{
+	while (a_pEnd > a_pBegin &&
+		(a_pEnd[-1] == ' ' || a_pEnd[-1] == '\t' || a_pEnd[-1] == '\r'))
+	{
+		--a_pEnd;
+	}
+
+	return a_pEnd;
+}
+
+bool OBJModel::TokenEquals(const char* a_pToken,
+	size_t a_length,
+	const char* a_pKeyword)
+{
+	return strlen(a_pKeyword) == a_length &&
+		memcmp(a_pToken, a_pKeyword, a_length) == 0;
+}
+
+const char* OBJModel::ParseFloat(const char* a_pCursor,
+	const char* a_pEnd,
+	float& a_value)
+{
+	// Every power of ten a double can represent exactly.
+	static const double sc_powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5,
+		1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+		1e18, 1e19, 1e20, 1e21, 1e22 };
+	const int maxExactPower = 22;
+	// Mantissas with more digits than this may not fit a double exactly.
+	const int maxExactDigits = 15;
+	const int maxStoredDigits = 19;
+	const char* pCursor = a_pCursor;
+	bool negative = false;
+
+	if (pCursor < a_pEnd && (*pCursor == '-' || *pCursor == '+'))
+	{
+		negative = *pCursor == '-';
+		++pCursor;
+	}
+
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool hasDigits = false;
+	bool truncated = false;
+
+	// Integer part.
+	while (pCursor < a_pEnd && *pCursor >= '0' && *pCursor <= '9')
+	{
+		hasDigits = true;
+
+		if (significantDigits < maxStoredDigits)
+		{
+			mantissa = mantissa * 10 + (*pCursor - '0');
+			significantDigits += mantissa != 0 ? 1 : 0;
+		}
+		else
+		{
+			++exponent;
+			truncated = true;
+		}
+
+		++pCursor;
+	}
+
+	// Fractional part.
+	if (pCursor < a_pEnd && *pCursor == '.')
+	{
+		++pCursor;
+
+		while (pCursor < a_pEnd && *pCursor >= '0' && *pCursor <= '9')
+		{
+			hasDigits = true;
+
+			if (significantDigits < maxStoredDigits)
+			{
+				mantissa = mantissa * 10 + (*pCursor - '0');
+				significantDigits += mantissa != 0 ? 1 : 0;
+				--exponent;
+			}
+			else
+			{
+				truncated = true;
 			}
+
+			++pCursor;
+		}
+	}
+
+	if (!hasDigits)
+	{
+		return a_pCursor;
+	}
+
+	// Exponent part. Only consumed if at least one digit follows the 'e'.
+	if (pCursor < a_pEnd && (*pCursor == 'e' || *pCursor == 'E'))
+	{
+		const char* pExponent = pCursor + 1;
+		bool negativeExponent = false;
+
+		if (pExponent < a_pEnd && (*pExponent == '-' || *pExponent == '+'))
+		{
+			negativeExponent = *pExponent == '-';
+			++pExponent;
 		}
 
-		if (m_pCurrentMaterial)
+		if (pExponent < a_pEnd && *pExponent >= '0' && *pExponent <= '9')
 		{
-			m_materials.push_back(m_pCurrentMaterial);
+			int exponentValue = 0;
+
+			while (pExponent < a_pEnd && *pExponent >= '0' && *pExponent <= '9')
+			{
+				if (exponentValue < 10000)
+				{
+					exponentValue = exponentValue * 10 + (*pExponent - '0');
+				}
+
+				++pExponent;
+			}
+
+			exponent += negativeExponent ? -exponentValue : exponentValue;
+			pCursor = pExponent;
 		}
+	}
+
+	// Fast path, both the mantissa and power of ten are exact doubles so a 
+	// single multiply or divide gives a correctly rounded double. Narrowing 
+	// that to a float rounds a second time, so the result is within 1 ulp 
+	// of the nearest float, off by one only for values close to halfway 
+	// between two floats.
+	if (!truncated &&
+		significantDigits <= maxExactDigits &&
+		exponent >= -maxExactPower &&
+		exponent <= maxExactPower)
+	{
+		double value = (double)mantissa;
+		value = exponent < 0 ? value / sc_powersOfTen[-exponent] :
+			value * sc_powersOfTen[exponent];
+		a_value = (float)(negative ? -value : value);
+		return pCursor;
+	}
+
+	// Slow path for long or extreme numbers. Copy the number so it can be 
+	// null terminated for the C library.
+	char buffer[64];
+	size_t length = pCursor - a_pCursor;
 
-		file.close();
+	if (length < sizeof(buffer))
+	{
+		memcpy(buffer, a_pCursor, length);
+		buffer[length] = '\0';
+		a_value = strtof(buffer, nullptr);
 	}
 	else
 	{
-		std::cout << "Error: Material Library Opening Unsuccessful.\n";
+		double value = (double)mantissa * pow(10.0, exponent);
+		a_value = (float)(negative ? -value : value);
+	}
+
+	return pCursor;
+}
+
+const char* OBJModel::ParseUnsignedInteger(const char* a_pCursor,
+	const char* a_pEnd,
+	unsigned int& a_value)
+{
+	const char* pCursor = a_pCursor;
+	unsigned int value = 0;
+
+	while (pCursor < a_pEnd && *pCursor >= '0' && *pCursor <= '9')
+	{
+		value = value * 10 + (*pCursor - '0');
+		++pCursor;
+	}
+
+	if (pCursor != a_pCursor)
+	{
+		a_value = value;
 	}
+
+	return pCursor;
 }
 
-OBJModel::OBJFaceTriplet OBJModel::ProcessTriplet(std::string a_triplet)
+// Reads up to four whitespace separated floats, missing components are zero.
+glm::vec4 OBJModel::ProcessVector(const char* a_pCursor, const char* a_pEnd)
 {
-	std::vector<std::string> vertexIndices = SplitStringAtCharacter(a_triplet, '/');
-	OBJFaceTriplet faceTriplet;
-	faceTriplet.vertex = 0;
-	faceTriplet.normalVertex = 0;
-	faceTriplet.uvCoordinate = 0;
-	faceTriplet.vertex = std::stoi(vertexIndices[0]);
+	glm::vec4 vectorData = glm::vec4(0.f);
+	const int maxComponents = 4;
 
-	if (vertexIndices.size() >= 2)
+	for (int i = 0; i < maxComponents; ++i)
 	{
-		if (vertexIndices[1].size() > 0)
+		a_pCursor = SkipWhitespace(a_pCursor, a_pEnd);
+		const char* pNext = ParseFloat(a_pCursor, a_pEnd, vectorData[i]);
+
+		if (pNext == a_pCursor)
 		{
-			faceTriplet.uvCoordinate = std::stoi(vertexIndices[1]);
+			break;
 		}
 
-		if (vertexIndices.size() >= 3)
+		a_pCursor = pNext;
+	}
+
+	return vectorData;
+}
+
+// Reads a v, v/vt, v//vn or v/vt/vn face corner. Unused indices are zero.
+const char* OBJModel::ProcessTriplet(const char* a_pCursor,
+	const char* a_pEnd,
+	OBJFaceTriplet& a_triplet)
+{
+	a_triplet.vertex = 0;
+	a_triplet.uvCoordinate = 0;
+	a_triplet.normalVertex = 0;
+	const char* pCursor = ParseUnsignedInteger(a_pCursor,
+		a_pEnd,
+		a_triplet.vertex);
+
+	if (pCursor == a_pCursor)
+	{
+		return a_pCursor;
+	}
+
+	if (pCursor < a_pEnd && *pCursor == '/')
+	{
+		pCursor = ParseUnsignedInteger(pCursor + 1,
+			a_pEnd,
+			a_triplet.uvCoordinate);
+
+		if (pCursor < a_pEnd && *pCursor == '/')
 		{
-			faceTriplet.normalVertex = std::stoi(vertexIndices[2]);
+			pCursor = ParseUnsignedInteger(pCursor + 1,
+				a_pEnd,
+				a_triplet.normalVertex);
 		}
 	}
 
-	return faceTriplet;
+	return pCursor;
 }